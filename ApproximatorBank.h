@@ -0,0 +1,159 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <stdexcept>
+#include <algorithm>
+#include <cstddef>
+
+#if defined(__AVX512F__) && defined(__AVX512DQ__)
+#include <immintrin.h>
+#define APPROXIMATOR_BANK_AVX512 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define APPROXIMATOR_BANK_AVX2 1
+#endif
+
+#include "LinearApproximatorHDL.h"
+
+//    LinearApproximatorHDL -    ,
+//    .     ( m ,  b ),
+//    update()      ,  8 (AVX-512) 
+// 4 (AVX2)    .
+//
+//      LinearApproximatorHDL::step: 64-
+//    64 ,    ,    -
+// .  AVX2   64- mullo,  64- 
+// ,      32- .  AVX2 (  ,
+//    )    step.
+//
+//     : -mavx2  -march=native.
+class ApproximatorBank {
+private:
+    std::vector<long long> m_fixed;
+    std::vector<long long> b_fixed;
+
+#if APPROXIMATOR_BANK_AVX512
+    static constexpr size_t LANES = 8;
+
+    //    FIXED_POINT_BITS.        -
+    //    vpsraq,    -,  
+    // GCC 12   -Wmaybe-uninitialized
+    static __m512i srai64(__m512i v) { return _mm512_maskz_srai_epi64(0xFF, v, FIXED_POINT_BITS); }
+
+    static size_t update_vector(long long* m, long long* b, const long long* x, const long long* y, size_t count) {
+        const __m512i lr = _mm512_set1_epi64(LEARNING_RATE_FIXED);
+        size_t i = 0;
+        for (; i + LANES <= count; i += LANES) {
+            __m512i vm = _mm512_loadu_si512(m + i);
+            __m512i vb = _mm512_loadu_si512(b + i);
+            __m512i vx = _mm512_loadu_si512(x + i);
+            __m512i vy = _mm512_loadu_si512(y + i);
+            __m512i y_pred = _mm512_add_epi64(srai64(_mm512_mullo_epi64(vm, vx)), vb);
+            __m512i error = _mm512_sub_epi64(y_pred, vy);
+            __m512i grad_m = srai64(_mm512_mullo_epi64(error, vx));
+            __m512i m_update = srai64(_mm512_mullo_epi64(lr, grad_m));
+            __m512i b_update = srai64(_mm512_mullo_epi64(lr, error));
+            _mm512_storeu_si512(m + i, _mm512_sub_epi64(vm, m_update));
+            _mm512_storeu_si512(b + i, _mm512_sub_epi64(vb, b_update));
+        }
+        return i;
+    }
+#elif APPROXIMATOR_BANK_AVX2
+    static constexpr size_t LANES = 4;
+    static_assert(LEARNING_RATE_FIXED >= 0 && LEARNING_RATE_FIXED <= 0xFFFFFFFFLL, "mullo64_const needs a 32-bit constant");
+
+    //  64  : lo*lo + ((hi*lo + lo*hi) << 32)
+    static __m256i mullo64(__m256i a, __m256i b) {
+        __m256i lo = _mm256_mul_epu32(a, b);
+        __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(a, 32), b),
+                                         _mm256_mul_epu32(a, _mm256_srli_epi64(b, 32)));
+        return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+    }
+
+    //     32- :   c ,
+    //     
+    static __m256i mullo64_const(__m256i a, __m256i c) {
+        __m256i lo = _mm256_mul_epu32(a, c);
+        __m256i cross = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), c);
+        return _mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32));
+    }
+
+    //    :    
+    //   xor/sub
+    static __m256i srai64(__m256i v) {
+        const __m256i sign = _mm256_set1_epi64x(1LL << (63 - FIXED_POINT_BITS));
+        __m256i shifted = _mm256_srli_epi64(v, FIXED_POINT_BITS);
+        return _mm256_sub_epi64(_mm256_xor_si256(shifted, sign), sign);
+    }
+
+    static size_t update_vector(long long* m, long long* b, const long long* x, const long long* y, size_t count) {
+        const __m256i lr = _mm256_set1_epi64x(LEARNING_RATE_FIXED);
+        size_t i = 0;
+        for (; i + LANES <= count; i += LANES) {
+            __m256i vm = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(m + i));
+            __m256i vb = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + i));
+            __m256i vx = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+            __m256i vy = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(y + i));
+            __m256i y_pred = _mm256_add_epi64(srai64(mullo64(vm, vx)), vb);
+            __m256i error = _mm256_sub_epi64(y_pred, vy);
+            __m256i grad_m = srai64(mullo64(error, vx));
+            __m256i m_update = srai64(mullo64_const(grad_m, lr));
+            __m256i b_update = srai64(mullo64_const(error, lr));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(m + i), _mm256_sub_epi64(vm, m_update));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(b + i), _mm256_sub_epi64(vb, b_update));
+        }
+        return i;
+    }
+#else
+    static constexpr size_t LANES = 1;
+
+    static size_t update_vector(long long*, long long*, const long long*, const long long*, size_t) { return 0; }
+#endif
+
+public:
+    explicit ApproximatorBank(size_t channels = 0) : m_fixed(channels, 0), b_fixed(channels, 0) {}
+
+    size_t size() const { return m_fixed.size(); }
+
+    //      (1 -  )
+    static constexpr size_t lanes() { return LANES; }
+
+    void reset() {
+        std::fill(m_fixed.begin(), m_fixed.end(), 0);
+        std::fill(b_fixed.begin(), b_fixed.end(), 0);
+    }
+
+    //     :  i   (x_fixed[i], y_fixed[i])
+    void update(const long long* x_fixed, const long long* y_fixed) {
+        size_t n = size();
+        size_t i = update_vector(m_fixed.data(), b_fixed.data(), x_fixed, y_fixed, n);
+        for (; i < n; ++i) LinearApproximatorHDL::step(m_fixed[i], b_fixed[i], x_fixed[i], y_fixed[i]);
+    }
+
+    // ,   prak1.cpp: epochs    .    :
+    // x_fixed[p * size() + i] -  p  i
+    void train(const long long* x_fixed, const long long* y_fixed, size_t points, int epochs) {
+        size_t n = size();
+        for (int e = 0; e < epochs; ++e) {
+            for (size_t p = 0; p < points; ++p) update(x_fixed + p * n, y_fixed + p * n);
+        }
+    }
+
+    void set_channel(size_t channel, const LinearApproximatorHDL& model) {
+        auto [m, b] = model.getCoeffsFixed();
+        m_fixed.at(channel) = m;
+        b_fixed.at(channel) = b;
+    }
+
+    LinearApproximatorHDL get_channel(size_t channel) const {
+        LinearApproximatorHDL model;
+        model.setCoeffsFixed(m_fixed.at(channel), b_fixed.at(channel));
+        return model;
+    }
+
+    std::pair<long long, long long> getCoeffsFixed(size_t channel) const { return {m_fixed.at(channel), b_fixed.at(channel)}; }
+
+    std::pair<double, double> getCoeffsDouble(size_t channel) const {
+        return {fixed_to_double(m_fixed.at(channel)), fixed_to_double(b_fixed.at(channel))};
+    }
+};
@@ -0,0 +1,233 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <exception>
+#include <stdexcept>
+#include <algorithm>
+#include <cstdint>
+
+#include "ThreadPool.h"
+
+//      6 -> 32 -> 16 -> 2  generate_weights.cpp:
+//   y = m*x + b,    ,  -  (x, y),
+//  -  (m, b).
+//
+//   std::mt19937,    , 
+//   Philox4x32-10:     -   
+//  (seed, ,  ).         
+//    ,       .  
+//   LANES:     -  ,    
+//    (32x32->64  Philox   vpmuludq).
+
+struct LineBatchRanges {
+    double m_b_min, m_b_max;
+    double x_min, x_max;
+    double y_min, y_max;
+};
+
+class PhiloxLineGenerator {
+public:
+    static constexpr size_t NUM_POINTS = 3;
+    static constexpr size_t INPUT_SIZE = NUM_POINTS * 2;
+    static constexpr size_t OUTPUT_SIZE = 2;
+    static constexpr size_t LANES = 16;
+
+private:
+    static constexpr uint32_t PHILOX_M0 = 0xD2511F53;
+    static constexpr uint32_t PHILOX_M1 = 0xCD9E8D57;
+    static constexpr uint32_t PHILOX_W0 = 0x9E3779B9;
+    static constexpr uint32_t PHILOX_W1 = 0xBB67AE85;
+    static constexpr int PHILOX_ROUNDS = 10;
+
+    //    5  (m, b,  x):   Philox  4 
+    static constexpr uint32_t BLOCKS = 2;
+
+    uint32_t key0, key1;
+    LineBatchRanges ranges;
+
+    // Philox4x32-10   LANES , c[][]
+    void philox(uint32_t (&c)[4][LANES]) const {
+        uint32_t k0 = key0, k1 = key1;
+        for (int round = 0; round < PHILOX_ROUNDS; ++round) {
+            for (size_t l = 0; l < LANES; ++l) {
+                uint64_t p0 = static_cast<uint64_t>(PHILOX_M0) * c[0][l];
+                uint64_t p1 = static_cast<uint64_t>(PHILOX_M1) * c[2][l];
+                uint32_t n0 = static_cast<uint32_t>(p1 >> 32) ^ c[1][l] ^ k0;
+                uint32_t n2 = static_cast<uint32_t>(p0 >> 32) ^ c[3][l] ^ k1;
+                c[1][l] = static_cast<uint32_t>(p1);
+                c[3][l] = static_cast<uint32_t>(p0);
+                c[0][l] = n0;
+                c[2][l] = n2;
+            }
+            k0 += PHILOX_W0;
+            k1 += PHILOX_W1;
+        }
+    }
+
+    //    (min, max)  32- 
+    static double uniform(uint32_t word, double min, double max) {
+        double u = (static_cast<double>(word) + 0.5) * (1.0 / 4294967296.0);
+        return min + (max - min) * u;
+    }
+
+    //     [-1, 1],    й1
+    static double normalize(double val, double min, double max) { return 2.0 * (val - min) / (max - min) - 1.0; }
+
+public:
+    PhiloxLineGenerator(uint64_t seed, const LineBatchRanges& ranges)
+        : key0(static_cast<uint32_t>(seed)), key1(static_cast<uint32_t>(seed >> 32)), ranges(ranges) {}
+
+    const LineBatchRanges& get_ranges() const { return ranges; }
+
+    //   [first, last)   step. X - batch x INPUT_SIZE,
+    // Y - batch x OUTPUT_SIZE, row-major,     .
+    template<typename T>
+    void generate(uint64_t step, size_t first, size_t last, T* X, T* Y) const {
+        uint32_t words[BLOCKS][4][LANES];
+        double m[LANES], b[LANES], x[NUM_POINTS][LANES];
+
+        for (size_t row = first; row < last; row += LANES) {
+            for (uint32_t block = 0; block < BLOCKS; ++block) {
+                for (size_t l = 0; l < LANES; ++l) {
+                    words[block][0][l] = static_cast<uint32_t>(row + l);
+                    words[block][1][l] = static_cast<uint32_t>(step);
+                    words[block][2][l] = static_cast<uint32_t>(step >> 32);
+                    words[block][3][l] = block;
+                }
+                philox(words[block]);
+            }
+
+            for (size_t l = 0; l < LANES; ++l) {
+                m[l] = uniform(words[0][0][l], ranges.m_b_min, ranges.m_b_max);
+                b[l] = uniform(words[0][1][l], ranges.m_b_min, ranges.m_b_max);
+                x[0][l] = uniform(words[0][2][l], ranges.x_min, ranges.x_max);
+                x[1][l] = uniform(words[0][3][l], ranges.x_min, ranges.x_max);
+                x[2][l] = uniform(words[1][0][l], ranges.x_min, ranges.x_max);
+            }
+
+            size_t count = std::min(LANES, last - row);
+            for (size_t l = 0; l < count; ++l) {
+                T* in = X + (row + l) * INPUT_SIZE;
+                for (size_t p = 0; p < NUM_POINTS; ++p) {
+                    double y = m[l] * x[p][l] + b[l];
+                    in[p * 2 + 0] = static_cast<T>(normalize(x[p][l], ranges.x_min, ranges.x_max));
+                    in[p * 2 + 1] = static_cast<T>(normalize(y, ranges.y_min, ranges.y_max));
+                }
+                T* out = Y + (row + l) * OUTPUT_SIZE;
+                out[0] = static_cast<T>(normalize(m[l], ranges.m_b_min, ranges.m_b_max));
+                out[1] = static_cast<T>(normalize(b[l], ranges.m_b_min, ranges.m_b_max));
+            }
+        }
+    }
+};
+
+//  :      k+1 (,  ),
+//        k.      .
+template<typename T>
+class BatchPipeline {
+public:
+    struct Batch {
+        uint64_t step = 0;
+        std::vector<T> X; // batch_size x INPUT_SIZE
+        std::vector<T> Y; // batch_size x OUTPUT_SIZE
+        bool ready = false;
+    };
+
+private:
+    const PhiloxLineGenerator& generator;
+    size_t batch_size;
+    uint64_t first_step, end_step;
+    ThreadPool pool;
+
+    Batch slots[2];
+    uint64_t consumed = 0;
+    bool holding = false;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stopping = false;
+    std::exception_ptr error;
+    std::thread producer;
+
+    void fill(Batch& batch, uint64_t step) {
+        batch.step = step;
+        //   LANES,       
+        size_t lanes = PhiloxLineGenerator::LANES;
+        size_t grain = (batch_size + pool.size() * 2 - 1) / (pool.size() * 2);
+        grain = std::max(lanes, (grain + lanes - 1) / lanes * lanes);
+        pool.parallel_for(0, batch_size, grain, [&](size_t begin, size_t end) {
+            generator.generate(step, begin, end, batch.X.data(), batch.Y.data());
+        });
+    }
+
+    void produce() {
+        try {
+            for (uint64_t step = first_step; step < end_step; ++step) {
+                Batch& batch = slots[step % 2];
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [&] { return stopping || !batch.ready; });
+                    if (stopping) return;
+                }
+                fill(batch, step);
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    batch.ready = true;
+                }
+                cv.notify_all();
+            }
+        } catch (...) {
+            std::lock_guard<std::mutex> lock(mutex);
+            error = std::current_exception();
+            cv.notify_all();
+        }
+    }
+
+public:
+    // threads -      (    )
+    BatchPipeline(const PhiloxLineGenerator& generator, size_t batch_size, uint64_t first_step, uint64_t steps,
+                  size_t threads = std::max(2u, std::thread::hardware_concurrency()) - 1)
+        : generator(generator), batch_size(batch_size), first_step(first_step), end_step(first_step + steps), pool(threads) {
+        if (batch_size == 0) throw std::runtime_error("Batch size must be positive");
+        for (auto& slot : slots) {
+            slot.X.assign(batch_size * PhiloxLineGenerator::INPUT_SIZE, T(0));
+            slot.Y.assign(batch_size * PhiloxLineGenerator::OUTPUT_SIZE, T(0));
+        }
+        producer = std::thread([this] { produce(); });
+    }
+
+    ~BatchPipeline() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_all();
+        producer.join();
+    }
+
+    BatchPipeline(const BatchPipeline&) = delete;
+    BatchPipeline& operator=(const BatchPipeline&) = delete;
+
+    size_t get_batch_size() const { return batch_size; }
+
+    //     .      next():
+    //          .
+    const Batch& next() {
+        std::unique_lock<std::mutex> lock(mutex);
+        if (holding) {
+            slots[(first_step + consumed - 1) % 2].ready = false;
+            holding = false;
+            cv.notify_all();
+        }
+        if (first_step + consumed >= end_step) throw std::runtime_error("Batch pipeline is exhausted");
+
+        Batch& batch = slots[(first_step + consumed) % 2];
+        cv.wait(lock, [&] { return batch.ready || error; });
+        if (!batch.ready) std::rethrow_exception(error);
+        ++consumed;
+        holding = true;
+        return batch;
+    }
+};
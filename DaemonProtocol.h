@@ -0,0 +1,298 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <utility>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+//    neiro_daemon (Unix-, SOCK_STREAM).
+//  -  16    :
+//   magic (4) | op (2) | status (2) | id (4) | length (4) | payload (length ).
+//   -   ,   UartProtocol. id  , 
+//      ;        
+//   (   ,   ).
+//
+//  (    op):
+//   Infer   - n     6  int32 (fixed-point,   UART) -> n  (m, b) int32;
+//   Fit     - n  (x, y) double -> (m, b) double,    Trainer;
+//   Load    - (m, b) double ->  ,    NeuroProcessor ;
+//   Process - n  x double -> n  y = m*x + b  NeuroProcessor;
+//   Stats   -  -> StatsReply.
+namespace DaemonProtocol {
+    constexpr uint32_t MAGIC = 0x3144524E; // "NRD1"
+    constexpr size_t HEADER_BYTES = 16;
+    constexpr uint32_t MAX_PAYLOAD = 1u << 20;
+
+    constexpr size_t QUERY_BYTES = 6 * 4;
+    constexpr size_t REPLY_BYTES = 2 * 4;
+    constexpr size_t POINT_BYTES = 2 * 8;
+    constexpr size_t STATS_BYTES = 8 * 8;
+
+    enum class Op : uint16_t { Infer = 1, Fit = 2, Load = 3, Process = 4, Stats = 5 };
+
+    enum class Status : uint16_t {
+        Ok = 0,
+        BadRequest = 1,  //  op      
+        Unsolvable = 2,  // Fit:      x 
+        NoModel = 3      // Infer:     
+    };
+
+    struct FrameHeader {
+        uint32_t magic = MAGIC;
+        Op op = Op::Stats;
+        Status status = Status::Ok;
+        uint32_t id = 0;
+        uint32_t length = 0;
+    };
+
+    struct StatsReply {
+        uint64_t requests = 0;     //  
+        uint64_t queries = 0;      //    (Infer)  
+        uint64_t batches = 0;      //   
+        double uptime = 0.0;       //   
+        double p50_us = 0.0;       //       
+        double p99_us = 0.0;
+        double requests_per_sec = 0.0;
+        double mean_batch = 0.0;   //      
+    };
+
+    inline void put_u16(uint8_t* dst, uint16_t v) {
+        dst[0] = static_cast<uint8_t>(v);
+        dst[1] = static_cast<uint8_t>(v >> 8);
+    }
+
+    inline uint16_t get_u16(const uint8_t* src) {
+        return static_cast<uint16_t>(src[0] | (src[1] << 8));
+    }
+
+    inline void put_u32(uint8_t* dst, uint32_t v) {
+        for (int i = 0; i < 4; ++i) dst[i] = static_cast<uint8_t>(v >> (i * 8));
+    }
+
+    inline uint32_t get_u32(const uint8_t* src) {
+        uint32_t v = 0;
+        for (int i = 0; i < 4; ++i) v |= static_cast<uint32_t>(src[i]) << (i * 8);
+        return v;
+    }
+
+    inline void put_u64(uint8_t* dst, uint64_t v) {
+        for (int i = 0; i < 8; ++i) dst[i] = static_cast<uint8_t>(v >> (i * 8));
+    }
+
+    inline uint64_t get_u64(const uint8_t* src) {
+        uint64_t v = 0;
+        for (int i = 0; i < 8; ++i) v |= static_cast<uint64_t>(src[i]) << (i * 8);
+        return v;
+    }
+
+    inline void put_i32(uint8_t* dst, int32_t v) { put_u32(dst, static_cast<uint32_t>(v)); }
+    inline int32_t get_i32(const uint8_t* src) { return static_cast<int32_t>(get_u32(src)); }
+
+    inline void put_f64(uint8_t* dst, double v) {
+        uint64_t bits;
+        std::memcpy(&bits, &v, sizeof(bits));
+        put_u64(dst, bits);
+    }
+
+    inline double get_f64(const uint8_t* src) {
+        uint64_t bits = get_u64(src);
+        double v;
+        std::memcpy(&v, &bits, sizeof(v));
+        return v;
+    }
+
+    inline void put_header(uint8_t* dst, const FrameHeader& h) {
+        put_u32(dst, h.magic);
+        put_u16(dst + 4, static_cast<uint16_t>(h.op));
+        put_u16(dst + 6, static_cast<uint16_t>(h.status));
+        put_u32(dst + 8, h.id);
+        put_u32(dst + 12, h.length);
+    }
+
+    inline FrameHeader get_header(const uint8_t* src) {
+        FrameHeader h;
+        h.magic = get_u32(src);
+        h.op = static_cast<Op>(get_u16(src + 4));
+        h.status = static_cast<Status>(get_u16(src + 6));
+        h.id = get_u32(src + 8);
+        h.length = get_u32(src + 12);
+        return h;
+    }
+
+    //   buffer  :   length    payload
+    inline void append_frame(std::vector<uint8_t>& buffer, Op op, Status status, uint32_t id,
+                             const uint8_t* payload, size_t length) {
+        size_t at = buffer.size();
+        buffer.resize(at + HEADER_BYTES + length);
+        put_header(buffer.data() + at, FrameHeader{MAGIC, op, status, id, static_cast<uint32_t>(length)});
+        if (length > 0) std::memcpy(buffer.data() + at + HEADER_BYTES, payload, length);
+    }
+
+    inline void put_stats(uint8_t* dst, const StatsReply& s) {
+        put_u64(dst, s.requests);
+        put_u64(dst + 8, s.queries);
+        put_u64(dst + 16, s.batches);
+        put_f64(dst + 24, s.uptime);
+        put_f64(dst + 32, s.p50_us);
+        put_f64(dst + 40, s.p99_us);
+        put_f64(dst + 48, s.requests_per_sec);
+        put_f64(dst + 56, s.mean_batch);
+    }
+
+    inline StatsReply get_stats(const uint8_t* src) {
+        StatsReply s;
+        s.requests = get_u64(src);
+        s.queries = get_u64(src + 8);
+        s.batches = get_u64(src + 16);
+        s.uptime = get_f64(src + 24);
+        s.p50_us = get_f64(src + 32);
+        s.p99_us = get_f64(src + 40);
+        s.requests_per_sec = get_f64(src + 48);
+        s.mean_batch = get_f64(src + 56);
+        return s;
+    }
+
+    inline sockaddr_un make_address(const std::string& path) {
+        sockaddr_un addr{};
+        addr.sun_family = AF_UNIX;
+        if (path.size() >= sizeof(addr.sun_path)) throw std::runtime_error("Socket path too long: " + path);
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        return addr;
+    }
+}
+
+//   :   -  .  
+//        .
+class DaemonConnection {
+private:
+    int fd = -1;
+    uint32_t next_id = 1;
+    std::vector<uint8_t> buffer;
+
+    void write_all(const uint8_t* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::send(fd, data, size, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("Socket write failed: ") + std::strerror(errno));
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+    }
+
+    void read_all(uint8_t* data, size_t size) {
+        while (size > 0) {
+            ssize_t n = ::recv(fd, data, size, 0);
+            if (n == 0) throw std::runtime_error("Daemon closed the connection");
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                throw std::runtime_error(std::string("Socket read failed: ") + std::strerror(errno));
+            }
+            data += n;
+            size -= static_cast<size_t>(n);
+        }
+    }
+
+public:
+    explicit DaemonConnection(const std::string& path) {
+        sockaddr_un addr = DaemonProtocol::make_address(path);
+        fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd < 0) throw std::runtime_error(std::string("Cannot create socket: ") + std::strerror(errno));
+        if (::connect(fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0) {
+            int err = errno;
+            ::close(fd);
+            throw std::runtime_error("Cannot connect to " + path + ": " + std::strerror(err));
+        }
+    }
+
+    ~DaemonConnection() {
+        if (fd >= 0) ::close(fd);
+    }
+
+    DaemonConnection(const DaemonConnection&) = delete;
+    DaemonConnection& operator=(const DaemonConnection&) = delete;
+
+    //       ;   -  reply
+    DaemonProtocol::Status call(DaemonProtocol::Op op, const uint8_t* payload, size_t length, std::vector<uint8_t>& reply) {
+        using namespace DaemonProtocol;
+        if (length > MAX_PAYLOAD) throw std::runtime_error("Request too large");
+        uint32_t id = next_id++;
+        buffer.clear();
+        append_frame(buffer, op, Status::Ok, id, payload, length);
+        write_all(buffer.data(), buffer.size());
+
+        uint8_t raw[HEADER_BYTES];
+        read_all(raw, HEADER_BYTES);
+        FrameHeader h = get_header(raw);
+        if (h.magic != MAGIC || h.id != id || h.op != op || h.length > MAX_PAYLOAD) {
+            throw std::runtime_error("Malformed reply from daemon");
+        }
+        reply.resize(h.length);
+        if (h.length > 0) read_all(reply.data(), h.length);
+        return h.status;
+    }
+
+    // count   6  -> count  (m, b)
+    DaemonProtocol::Status infer(const int32_t* coords, size_t count, int32_t* out) {
+        using namespace DaemonProtocol;
+        std::vector<uint8_t> payload(count * QUERY_BYTES), reply;
+        for (size_t i = 0; i < count * 6; ++i) put_i32(payload.data() + i * 4, coords[i]);
+        Status status = call(Op::Infer, payload.data(), payload.size(), reply);
+        if (status != Status::Ok) return status;
+        if (reply.size() != count * REPLY_BYTES) throw std::runtime_error("Malformed reply from daemon");
+        for (size_t i = 0; i < count * 2; ++i) out[i] = get_i32(reply.data() + i * 4);
+        return status;
+    }
+
+    DaemonProtocol::Status fit(const std::vector<std::pair<double, double>>& points, double& m, double& b) {
+        using namespace DaemonProtocol;
+        std::vector<uint8_t> payload(points.size() * POINT_BYTES), reply;
+        for (size_t i = 0; i < points.size(); ++i) {
+            put_f64(payload.data() + i * POINT_BYTES, points[i].first);
+            put_f64(payload.data() + i * POINT_BYTES + 8, points[i].second);
+        }
+        Status status = call(Op::Fit, payload.data(), payload.size(), reply);
+        if (status != Status::Ok) return status;
+        if (reply.size() != POINT_BYTES) throw std::runtime_error("Malformed reply from daemon");
+        m = get_f64(reply.data());
+        b = get_f64(reply.data() + 8);
+        return status;
+    }
+
+    DaemonProtocol::Status load(double m, double b) {
+        using namespace DaemonProtocol;
+        uint8_t payload[POINT_BYTES];
+        put_f64(payload, m);
+        put_f64(payload + 8, b);
+        std::vector<uint8_t> reply;
+        return call(Op::Load, payload, sizeof(payload), reply);
+    }
+
+    DaemonProtocol::Status process(const std::vector<double>& xs, std::vector<double>& ys) {
+        using namespace DaemonProtocol;
+        std::vector<uint8_t> payload(xs.size() * 8), reply;
+        for (size_t i = 0; i < xs.size(); ++i) put_f64(payload.data() + i * 8, xs[i]);
+        Status status = call(Op::Process, payload.data(), payload.size(), reply);
+        if (status != Status::Ok) return status;
+        if (reply.size() != xs.size() * 8) throw std::runtime_error("Malformed reply from daemon");
+        ys.resize(xs.size());
+        for (size_t i = 0; i < xs.size(); ++i) ys[i] = get_f64(reply.data() + i * 8);
+        return status;
+    }
+
+    DaemonProtocol::StatsReply stats() {
+        using namespace DaemonProtocol;
+        std::vector<uint8_t> reply;
+        if (call(Op::Stats, nullptr, 0, reply) != Status::Ok || reply.size() != STATS_BYTES) {
+            throw std::runtime_error("Malformed stats reply from daemon");
+        }
+        return get_stats(reply.data());
+    }
+};
@@ -0,0 +1,286 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+
+//       ->  -> 
+// (main2.cpp, prak1_1.cpp)      
+// (trace_replay.cpp).
+//
+//        ( ,  ):  -
+//   ,  32     ,   
+//  .     FLUSH_INTERVAL     
+//    .     :  ,
+//        Dropped.    ,
+// trace_event -   .
+//
+//     NEIRO_TRACE=<> (TraceSession).
+// :  TraceFormat::FileHeader   TraceRecord    -
+//    ,   ; read_trace .
+
+enum class TraceEvent : uint16_t {
+    Input = 1,        //     (x, y) -    trace_replay
+    Command = 2,      //  : a - TraceCommand
+    Handoff = 3,      //    (x, y)
+    TrainBegin = 4,   // a -  
+    TrainEnd = 5,     //   (m, b)
+    RenderBegin = 6,  // a -    
+    RenderEnd = 7,
+    Restored = 8,     //       (x, y)
+    Dropped = 9       // a -    -  
+};
+
+enum class TraceCommand : uint16_t { ModeOls = 1, ModeRansac = 2, ModeHuber = 3 };
+
+struct TraceRecord {
+    uint64_t time_ns;  //   , steady_clock
+    uint16_t type;     // TraceEvent
+    uint16_t thread;   //    
+    uint32_t seq;      //    :  - 
+    double a;
+    double b;
+};
+static_assert(sizeof(TraceRecord) == 32, "TraceRecord must stay 32 bytes");
+
+namespace TraceFormat {
+    constexpr uint32_t MAGIC = 0x4352544E; // "NTRC"
+    constexpr uint32_t VERSION = 1;
+
+    struct FileHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t start_unix_ns; //      
+        char program[16];       //   : main2, prak1_1, trace_replay
+    };
+    static_assert(sizeof(FileHeader) == 32, "FileHeader must stay 32 bytes");
+}
+
+inline const char* trace_event_name(uint16_t type) {
+    switch (static_cast<TraceEvent>(type)) {
+    case TraceEvent::Input: return "input";
+    case TraceEvent::Command: return "command";
+    case TraceEvent::Handoff: return "handoff";
+    case TraceEvent::TrainBegin: return "train_begin";
+    case TraceEvent::TrainEnd: return "train_end";
+    case TraceEvent::RenderBegin: return "render_begin";
+    case TraceEvent::RenderEnd: return "render_end";
+    case TraceEvent::Restored: return "restored";
+    case TraceEvent::Dropped: return "dropped";
+    }
+    return "unknown";
+}
+
+//   . head   , tail -   ,
+//   acquire/release;     .
+class TraceRing {
+public:
+    static constexpr size_t CAPACITY = 8192; //  
+
+private:
+    alignas(64) std::atomic<uint64_t> head{0};
+    alignas(64) std::atomic<uint64_t> tail{0};
+    alignas(64) std::atomic<uint64_t> dropped{0};
+    uint32_t next_seq = 0;
+    TraceRecord records[CAPACITY];
+
+public:
+    const uint16_t thread;
+
+    explicit TraceRing(uint16_t thread) : thread(thread) {}
+
+    //  -
+    void push(uint64_t time_ns, TraceEvent type, double a, double b) {
+        uint64_t h = head.load(std::memory_order_relaxed);
+        uint32_t seq = next_seq++;
+        if (h - tail.load(std::memory_order_acquire) >= CAPACITY) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        records[h & (CAPACITY - 1)] = TraceRecord{time_ns, static_cast<uint16_t>(type), thread, seq, a, b};
+        head.store(h + 1, std::memory_order_release);
+    }
+
+    //   :    out,      
+    uint64_t drain(std::vector<TraceRecord>& out) {
+        uint64_t t = tail.load(std::memory_order_relaxed);
+        uint64_t h = head.load(std::memory_order_acquire);
+        for (; t < h; ++t) out.push_back(records[t & (CAPACITY - 1)]);
+        tail.store(t, std::memory_order_release);
+        return dropped.exchange(0, std::memory_order_relaxed);
+    }
+};
+
+class EventTrace {
+public:
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL{20};
+
+private:
+    std::atomic<bool> active{false};
+    std::chrono::steady_clock::time_point start;
+
+    std::mutex rings_mutex;
+    std::vector<std::unique_ptr<TraceRing>> rings;
+
+    std::mutex flush_mutex;
+    std::condition_variable flush_cv;
+    bool stopping = false;
+    std::thread flusher;
+    std::FILE* file = nullptr;
+
+    EventTrace() = default;
+
+    TraceRing* register_ring() {
+        std::lock_guard<std::mutex> lock(rings_mutex);
+        rings.push_back(std::make_unique<TraceRing>(static_cast<uint16_t>(rings.size())));
+        return rings.back().get();
+    }
+
+    //   ;     ,    EventTrace
+    TraceRing& local_ring() {
+        static thread_local TraceRing* ring = nullptr;
+        if (!ring) ring = register_ring();
+        return *ring;
+    }
+
+    uint64_t now_ns() const {
+        return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    void drain_all(std::vector<TraceRecord>& batch) {
+        std::vector<TraceRing*> snapshot;
+        {
+            std::lock_guard<std::mutex> lock(rings_mutex);
+            for (auto& ring : rings) snapshot.push_back(ring.get());
+        }
+        for (TraceRing* ring : snapshot) {
+            uint64_t lost = ring->drain(batch);
+            if (lost > 0) batch.push_back(TraceRecord{now_ns(), static_cast<uint16_t>(TraceEvent::Dropped), ring->thread, 0,
+                                                      static_cast<double>(lost), 0.0});
+        }
+        if (!batch.empty()) {
+            std::fwrite(batch.data(), sizeof(TraceRecord), batch.size(), file);
+            std::fflush(file);
+            batch.clear();
+        }
+    }
+
+    void flush_loop() {
+        std::vector<TraceRecord> batch;
+        batch.reserve(TraceRing::CAPACITY);
+        std::unique_lock<std::mutex> lock(flush_mutex);
+        while (!stopping) {
+            flush_cv.wait_for(lock, FLUSH_INTERVAL, [&] { return stopping; });
+            lock.unlock();
+            drain_all(batch);
+            lock.lock();
+        }
+    }
+
+public:
+    //        :  
+    // (  )      
+    static EventTrace& global() {
+        static EventTrace* instance = new EventTrace();
+        return *instance;
+    }
+
+    EventTrace(const EventTrace&) = delete;
+    EventTrace& operator=(const EventTrace&) = delete;
+
+    bool enabled() const { return active.load(std::memory_order_acquire); }
+
+    void open(const std::string& path, const char* program) {
+        if (enabled()) throw std::runtime_error("Trace is already open");
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) throw std::runtime_error("Cannot create trace file " + path);
+
+        TraceFormat::FileHeader header{};
+        header.magic = TraceFormat::MAGIC;
+        header.version = TraceFormat::VERSION;
+        header.start_unix_ns = static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::system_clock::now().time_since_epoch()).count());
+        std::strncpy(header.program, program, sizeof(header.program) - 1);
+        std::fwrite(&header, sizeof(header), 1, file);
+
+        start = std::chrono::steady_clock::now();
+        stopping = false;
+        flusher = std::thread([this] { flush_loop(); });
+        active.store(true, std::memory_order_release);
+    }
+
+    //     ,    
+    void close() {
+        if (!enabled()) return;
+        active.store(false, std::memory_order_release);
+        {
+            std::lock_guard<std::mutex> lock(flush_mutex);
+            stopping = true;
+        }
+        flush_cv.notify_one();
+        flusher.join();
+        std::vector<TraceRecord> batch;
+        drain_all(batch);
+        std::fclose(file);
+        file = nullptr;
+    }
+
+    void record(TraceEvent type, double a, double b) {
+        if (!active.load(std::memory_order_acquire)) return;
+        local_ring().push(now_ns(), type, a, b);
+    }
+};
+
+inline void trace_event(TraceEvent type, double a = 0.0, double b = 0.0) {
+    EventTrace::global().record(type, a, b);
+}
+
+//  ,    ,      
+class TraceSession {
+public:
+    explicit TraceSession(const char* program, const char* variable = "NEIRO_TRACE") {
+        const char* path = std::getenv(variable);
+        if (path && *path) {
+            EventTrace::global().open(path, program);
+            std::fprintf(stderr, "    %s\n", path);
+        }
+    }
+
+    ~TraceSession() { EventTrace::global().close(); }
+
+    TraceSession(const TraceSession&) = delete;
+    TraceSession& operator=(const TraceSession&) = delete;
+};
+
+//  ,    (   -    )
+inline std::vector<TraceRecord> read_trace(const std::string& path, TraceFormat::FileHeader* header_out = nullptr) {
+    std::unique_ptr<std::FILE, int (*)(std::FILE*)> file(std::fopen(path.c_str(), "rb"), std::fclose);
+    if (!file) throw std::runtime_error("Cannot open trace file " + path);
+    TraceFormat::FileHeader header{};
+    if (std::fread(&header, sizeof(header), 1, file.get()) != 1 || header.magic != TraceFormat::MAGIC) {
+        throw std::runtime_error("Not a trace file: " + path);
+    }
+    if (header.version != TraceFormat::VERSION) throw std::runtime_error("Unsupported trace version in " + path);
+    if (header_out) *header_out = header;
+
+    std::vector<TraceRecord> records;
+    TraceRecord chunk[1024];
+    size_t n;
+    while ((n = std::fread(chunk, sizeof(TraceRecord), 1024, file.get())) > 0) records.insert(records.end(), chunk, chunk + n);
+    std::stable_sort(records.begin(), records.end(), [](const TraceRecord& x, const TraceRecord& y) {
+        if (x.time_ns != y.time_ns) return x.time_ns < y.time_ns;
+        if (x.thread != y.thread) return x.thread < y.thread;
+        return x.seq < y.seq;
+    });
+    return records;
+}
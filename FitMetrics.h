@@ -0,0 +1,223 @@
+#pragma once
+#include <vector>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <algorithm>
+
+#include "LineStats.h"
+
+//   ,     ,   
+//  .
+//
+// RMSE  R^2     LineStats  O(1):  
+//  -  syy - sxy^2/sxx.      .
+//
+//      :    ,   
+//   .      , 
+//    (prequential-):      ,
+//       ,   .
+//       .
+
+struct FitMetrics {
+    uint64_t count = 0;
+    bool valid = false;            //   (      x)
+    double rmse = 0.0;
+    double r2 = 0.0;
+    double mean_abs_residual = 0.0;
+    double p50 = 0.0;              //   
+    double p90 = 0.0;
+    double p99 = 0.0;
+};
+
+//    -  
+inline double residual_sse(const LineStats& s) {
+    if (!s.solvable()) return 0.0;
+    return std::max(0.0, s.syy - s.sxy * s.sxy / s.sxx);
+}
+
+// RMSE  R^2  O(1)
+inline void fill_fit_metrics(const LineStats& s, FitMetrics& out) {
+    out.count = s.count;
+    out.valid = s.solvable();
+    if (!out.valid) {
+        out.rmse = out.r2 = 0.0;
+        return;
+    }
+    double sse = residual_sse(s);
+    out.rmse = std::sqrt(sse / s.weight);
+    //  y :      
+    out.r2 = s.syy > 0.0 ? 1.0 - sse / s.syy : 1.0;
+}
+
+//      ( DDSketch):  v  
+//  ceil(log_gamma(v)),  -  .  - O(1),  -
+//   ,    1%   1e-9..1e9   ~2100.
+//          accuracy .
+class ResidualSketch {
+private:
+    static constexpr double MIN_VALUE = 1e-9; //  -  
+    static constexpr size_t MAX_BUCKETS = 4096;
+
+    double gamma;
+    double log_gamma;
+    std::vector<uint64_t> buckets;
+    int64_t offset = 0;   //   buckets[0]
+    uint64_t zero_count = 0;
+    uint64_t total = 0;
+
+    int64_t index_of(double v) const { return static_cast<int64_t>(std::ceil(std::log(v) / log_gamma)); }
+
+    double value_of(int64_t index) const { return 2.0 * std::pow(gamma, static_cast<double>(index)) / (gamma + 1.0); }
+
+public:
+    explicit ResidualSketch(double accuracy = 0.01)
+        : gamma((1.0 + accuracy) / (1.0 - accuracy)), log_gamma(std::log(gamma)) {}
+
+    uint64_t size() const { return total; }
+
+    void add(double v) {
+        v = std::abs(v);
+        ++total;
+        if (!(v > MIN_VALUE) || !std::isfinite(v)) {
+            ++zero_count;
+            return;
+        }
+        int64_t index = index_of(v);
+        if (buckets.empty()) {
+            buckets.assign(1, 0);
+            offset = index;
+        } else if (index < offset) {
+            buckets.insert(buckets.begin(), static_cast<size_t>(offset - index), 0);
+            offset = index;
+        } else if (index >= offset + static_cast<int64_t>(buckets.size())) {
+            buckets.resize(static_cast<size_t>(index - offset + 1), 0);
+        }
+        ++buckets[static_cast<size_t>(index - offset)];
+
+        //  :      ,  
+        //       
+        if (buckets.size() > MAX_BUCKETS) {
+            size_t extra = buckets.size() - MAX_BUCKETS;
+            for (size_t i = 0; i < extra; ++i) buckets[extra] += buckets[i];
+            buckets.erase(buckets.begin(), buckets.begin() + static_cast<std::ptrdiff_t>(extra));
+            offset += static_cast<int64_t>(extra);
+        }
+    }
+
+    // q  [0, 1]
+    double quantile(double q) const {
+        if (total == 0) return 0.0;
+        q = std::min(1.0, std::max(0.0, q));
+        uint64_t rank = static_cast<uint64_t>(q * static_cast<double>(total - 1));
+        if (rank < zero_count) return 0.0;
+        uint64_t seen = zero_count;
+        for (size_t i = 0; i < buckets.size(); ++i) {
+            seen += buckets[i];
+            if (seen > rank) return value_of(offset + static_cast<int64_t>(i));
+        }
+        return value_of(offset + static_cast<int64_t>(buckets.size()) - 1);
+    }
+
+    //      -   (Journal.h)
+    std::vector<uint64_t> export_state() const {
+        std::vector<uint64_t> state = {static_cast<uint64_t>(offset), zero_count, total};
+        state.insert(state.end(), buckets.begin(), buckets.end());
+        return state;
+    }
+
+    bool import_state(const std::vector<uint64_t>& state) {
+        if (state.size() < 3) return false;
+        offset = static_cast<int64_t>(state[0]);
+        zero_count = state[1];
+        total = state[2];
+        buckets.assign(state.begin() + 3, state.end());
+        return true;
+    }
+};
+
+//      : 72 ,    
+//  SeriesEngine,    
+struct LineFit {
+    LineStats stats;
+    double abs_residual_sum = 0.0;
+    uint64_t residual_count = 0;
+
+    //       , -1 -    
+    double add(double x, double y) {
+        double residual = -1.0;
+        if (stats.solvable()) {
+            auto [m, b] = stats.solve();
+            residual = std::abs(y - (m * x + b));
+            abs_residual_sum += residual;
+            ++residual_count;
+        }
+        stats.add(x, y);
+        return residual;
+    }
+
+    void fill(FitMetrics& out) const {
+        fill_fit_metrics(stats, out);
+        out.mean_abs_residual = residual_count > 0 ? abs_residual_sum / residual_count : 0.0;
+    }
+};
+
+//      . add() - O(1); metrics() 
+// ,        ,    
+//   .
+class FitTracker {
+private:
+    LineFit fit;
+    double sketch_accuracy;
+    ResidualSketch sketch;
+
+    mutable FitMetrics cached;
+    mutable bool dirty = true;
+
+public:
+    explicit FitTracker(double sketch_accuracy = 0.01) : sketch_accuracy(sketch_accuracy), sketch(sketch_accuracy) {}
+
+    void add(double x, double y) {
+        double residual = fit.add(x, y);
+        if (residual >= 0.0) sketch.add(residual);
+        dirty = true;
+    }
+
+    const LineStats& get_stats() const { return fit.stats; }
+
+    std::pair<double, double> solve() const { return fit.stats.solve(); }
+
+    const FitMetrics& metrics() const {
+        if (dirty) {
+            fit.fill(cached);
+            cached.p50 = sketch.quantile(0.50);
+            cached.p90 = sketch.quantile(0.90);
+            cached.p99 = sketch.quantile(0.99);
+            dirty = false;
+        }
+        return cached;
+    }
+
+    //      -   (Journal.h);   
+    std::vector<uint64_t> export_residuals() const {
+        uint64_t sum_bits;
+        std::memcpy(&sum_bits, &fit.abs_residual_sum, sizeof(sum_bits));
+        std::vector<uint64_t> state = {sum_bits, fit.residual_count};
+        auto sketch_state = sketch.export_state();
+        state.insert(state.end(), sketch_state.begin(), sketch_state.end());
+        return state;
+    }
+
+    //   .        .
+    void restore(const LineStats& saved_stats, const std::vector<uint64_t>& residuals) {
+        fit = LineFit();
+        fit.stats = saved_stats;
+        sketch = ResidualSketch(sketch_accuracy);
+        if (residuals.size() >= 2 &&
+            sketch.import_state(std::vector<uint64_t>(residuals.begin() + 2, residuals.end()))) {
+            std::memcpy(&fit.abs_residual_sum, &residuals[0], sizeof(fit.abs_residual_sum));
+            fit.residual_count = residuals[1];
+        }
+        dirty = true;
+    }
+};
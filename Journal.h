@@ -0,0 +1,544 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <optional>
+#include <algorithm>
+#include <chrono>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <cstdio>
+
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//     .
+//
+//  (*.journal) -      .   
+//      ,       .
+//      (seq)   .
+//
+//  (*.snap) -     seq:    (,
+//  ,  , ...).    
+// ,         , 
+//      ,     .
+//
+//      ,   ,   :   seq
+// ,   (  , rename  fsync ),  ,
+//  .     ,  rename   , 
+//            + .
+//      (    - ,  
+//   fsync ), recover()        ,
+//     .
+//
+//   ( ,    )   : 
+//     ,         
+//    retry_interval_ms,    .    ,
+// last_error()  .
+
+struct JournalPoint {
+    double x;
+    double y;
+};
+
+enum class SnapshotTag : uint32_t {
+    Points = 1,     // JournalPoint[]
+    LineStats = 2,  // LineStats (LineStats.h)
+    HdlCoeffs = 3,  // long long[2]:  m, b    
+    FitResiduals = 4, // uint64_t[]:     (FitTracker::export_residuals)
+};
+
+namespace JournalFormat {
+    constexpr uint32_t JOURNAL_MAGIC = 0x4C524A4E;  // "NJRL"
+    constexpr uint32_t SNAPSHOT_MAGIC = 0x50534E4E; // "NNSP"
+    constexpr uint32_t RECORD_MAGIC = 0x43455250;   // "PREC"
+    constexpr uint32_t VERSION = 1;
+
+    struct JournalHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint64_t base_seq; //   ,     
+        uint64_t reserved[2];
+    };
+
+    struct RecordHeader {
+        uint32_t magic;
+        uint32_t count;
+        uint64_t first_seq;
+        uint64_t checksum; // FNV-1a 64   
+    };
+
+    struct SnapshotHeader {
+        uint32_t magic;
+        uint32_t version;
+        uint32_t section_count;
+        uint32_t reserved;
+        uint64_t seq;      //      [0, seq)
+        uint64_t checksum; // FNV-1a 64  ,   
+    };
+
+    struct SectionHeader {
+        uint32_t tag;
+        uint32_t reserved;
+        uint64_t size; //  ,    8
+    };
+
+    static_assert(sizeof(JournalHeader) == 32, "JournalHeader must be 32 bytes");
+    static_assert(sizeof(RecordHeader) == 24, "RecordHeader must be 24 bytes");
+    static_assert(sizeof(SnapshotHeader) == 32, "SnapshotHeader must be 32 bytes");
+    static_assert(sizeof(SectionHeader) == 16, "SectionHeader must be 16 bytes");
+
+    inline uint64_t fnv1a(const void* data, size_t len, uint64_t hash = 0xcbf29ce484222325ULL) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        for (size_t i = 0; i < len; ++i) {
+            hash ^= bytes[i];
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    inline void write_all(int fd, const void* data, size_t len, const std::string& filename) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        while (len > 0) {
+            ssize_t n = ::write(fd, bytes, len);
+            if (n < 0) throw std::runtime_error("Failed to write " + filename);
+            bytes += n;
+            len -= static_cast<size_t>(n);
+        }
+    }
+
+    inline std::vector<uint8_t> read_file(const std::string& filename) {
+        std::vector<uint8_t> data;
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) return data;
+        struct stat st{};
+        if (fstat(fd, &st) == 0 && st.st_size > 0) {
+            data.resize(static_cast<size_t>(st.st_size));
+            size_t done = 0;
+            while (done < data.size()) {
+                ssize_t n = ::read(fd, data.data() + done, data.size() - done);
+                if (n <= 0) break;
+                done += static_cast<size_t>(n);
+            }
+            data.resize(done);
+        }
+        ::close(fd);
+        return data;
+    }
+
+    // fsync  :   rename     ,
+    //       
+    inline void sync_directory(const std::string& filename) {
+        size_t slash = filename.find_last_of('/');
+        std::string dir = slash == std::string::npos ? "." : (slash == 0 ? "/" : filename.substr(0, slash));
+        int fd = ::open(dir.c_str(), O_RDONLY | O_DIRECTORY);
+        if (fd < 0) throw std::runtime_error("Cannot open directory " + dir);
+        int rc = ::fsync(fd);
+        ::close(fd);
+        if (rc != 0) throw std::runtime_error("Failed to sync directory " + dir);
+    }
+}
+
+//  :    
+class Snapshot {
+private:
+    struct Section {
+        uint32_t tag;
+        std::vector<uint8_t> data;
+    };
+    std::vector<Section> sections;
+
+public:
+    uint64_t seq = 0;
+
+    template<typename T>
+    void add(SnapshotTag tag, const T* data, size_t count) {
+        Section section{static_cast<uint32_t>(tag), {}};
+        section.data.resize(count * sizeof(T));
+        if (count > 0) std::memcpy(section.data.data(), data, section.data.size());
+        sections.push_back(std::move(section));
+    }
+
+    template<typename T>
+    void add(SnapshotTag tag, const std::vector<T>& values) { add(tag, values.data(), values.size()); }
+
+    template<typename T>
+    void add(SnapshotTag tag, const T& value) { add(tag, &value, 1); }
+
+    bool has(SnapshotTag tag) const {
+        for (const auto& s : sections) if (s.tag == static_cast<uint32_t>(tag)) return true;
+        return false;
+    }
+
+    template<typename T>
+    std::vector<T> get(SnapshotTag tag) const {
+        for (const auto& s : sections) {
+            if (s.tag != static_cast<uint32_t>(tag)) continue;
+            if (s.data.size() % sizeof(T) != 0) throw std::runtime_error("Snapshot section has unexpected size");
+            std::vector<T> values(s.data.size() / sizeof(T));
+            if (!values.empty()) std::memcpy(values.data(), s.data.data(), s.data.size());
+            return values;
+        }
+        return {};
+    }
+
+    //    :     ,   .
+    //          rename.
+    void save(const std::string& filename) const {
+        using namespace JournalFormat;
+        std::vector<uint8_t> body;
+        for (const auto& s : sections) {
+            SectionHeader sh{s.tag, 0, s.data.size()};
+            const uint8_t* p = reinterpret_cast<const uint8_t*>(&sh);
+            body.insert(body.end(), p, p + sizeof(sh));
+            body.insert(body.end(), s.data.begin(), s.data.end());
+            body.resize((body.size() + 7) & ~size_t(7), 0);
+        }
+        SnapshotHeader h{SNAPSHOT_MAGIC, VERSION, static_cast<uint32_t>(sections.size()), 0, seq, 0};
+        h.checksum = fnv1a(body.data(), body.size());
+
+        std::string tmp = filename + ".tmp";
+        int fd = ::open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+        if (fd < 0) throw std::runtime_error("Cannot create " + tmp);
+        try {
+            write_all(fd, &h, sizeof(h), tmp);
+            write_all(fd, body.data(), body.size(), tmp);
+            if (::fsync(fd) != 0) throw std::runtime_error("Failed to sync " + tmp);
+        } catch (...) {
+            ::close(fd);
+            throw;
+        }
+        ::close(fd);
+        if (std::rename(tmp.c_str(), filename.c_str()) != 0) throw std::runtime_error("Cannot replace " + filename);
+        sync_directory(filename);
+    }
+
+    // false -      (    )
+    bool load(const std::string& filename) {
+        using namespace JournalFormat;
+        std::vector<uint8_t> data = read_file(filename);
+        if (data.size() < sizeof(SnapshotHeader)) return false;
+        SnapshotHeader h;
+        std::memcpy(&h, data.data(), sizeof(h));
+        if (h.magic != SNAPSHOT_MAGIC || h.version != VERSION) return false;
+        if (fnv1a(data.data() + sizeof(h), data.size() - sizeof(h)) != h.checksum) return false;
+
+        std::vector<Section> loaded;
+        size_t pos = sizeof(h);
+        for (uint32_t i = 0; i < h.section_count; ++i) {
+            SectionHeader sh;
+            if (data.size() - pos < sizeof(sh)) return false;
+            std::memcpy(&sh, data.data() + pos, sizeof(sh));
+            pos += sizeof(sh);
+            if (sh.size > data.size() - pos) return false;
+            loaded.push_back({sh.tag, std::vector<uint8_t>(data.begin() + pos, data.begin() + pos + sh.size)});
+            pos = (pos + sh.size + 7) & ~size_t(7);
+            if (pos > data.size()) return false; //    ,    
+        }
+        sections = std::move(loaded);
+        seq = h.seq;
+        return true;
+    }
+};
+
+//       
+class StateJournal {
+public:
+    struct Options {
+        size_t batch_points = 256;     // ,     
+        int flush_interval_ms = 50;    // ...   
+        bool sync = true;              // fdatasync   
+        int retry_interval_ms = 1000;  //    
+    };
+
+    struct Recovery {
+        Snapshot snapshot;               // seq = 0   ,    
+        bool has_snapshot = false;
+        std::vector<JournalPoint> tail;  //   ,  
+        uint64_t lost = 0;               // ,     ,    (    )
+        double milliseconds = 0.0;
+    };
+
+private:
+    std::string journal_file;
+    std::string snapshot_file;
+    Options options;
+    int fd = -1;
+    off_t good_size = 0; //       
+    bool torn = false;   //  good_size     
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::condition_variable flushed_cv;
+    std::vector<JournalPoint> pending;
+    uint64_t pending_first_seq = 0;
+    uint64_t next_seq = 0;
+    uint64_t written_seq = 0;
+    std::optional<Snapshot> pending_snapshot;
+    uint64_t snapshots_requested = 0;
+    uint64_t snapshots_done = 0;
+    bool flush_requested = false;
+    bool stopping = false;
+    std::string error;
+    std::thread writer;
+
+    //    ,       
+    void drop_torn_tail() {
+        if (!torn) return;
+        if (::ftruncate(fd, good_size) != 0) throw std::runtime_error("Cannot truncate " + journal_file);
+        torn = false;
+    }
+
+    void reset_file(uint64_t base_seq) {
+        using namespace JournalFormat;
+        torn = true;
+        good_size = 0;
+        if (::ftruncate(fd, 0) != 0 || ::lseek(fd, 0, SEEK_SET) != 0) {
+            throw std::runtime_error("Cannot truncate " + journal_file);
+        }
+        JournalHeader h{JOURNAL_MAGIC, VERSION, base_seq, {0, 0}};
+        write_all(fd, &h, sizeof(h), journal_file);
+        if (options.sync && ::fdatasync(fd) != 0) throw std::runtime_error("Failed to sync " + journal_file);
+        good_size = sizeof(h);
+        torn = false;
+    }
+
+    //    (good_size ),    
+    //   ,  options.sync,  
+    void write_record(const JournalPoint* points, size_t count, uint64_t first_seq) {
+        using namespace JournalFormat;
+        if (count == 0) return;
+        RecordHeader r{RECORD_MAGIC, static_cast<uint32_t>(count), first_seq, fnv1a(points, count * sizeof(JournalPoint))};
+        torn = true;
+        write_all(fd, &r, sizeof(r), journal_file);
+        write_all(fd, points, count * sizeof(JournalPoint), journal_file);
+        if (options.sync && ::fdatasync(fd) != 0) throw std::runtime_error("Failed to sync " + journal_file);
+        good_size += static_cast<off_t>(sizeof(r) + count * sizeof(JournalPoint));
+        torn = false;
+    }
+
+    void writer_loop() {
+        std::vector<JournalPoint> batch;
+        while (true) {
+            uint64_t first_seq;
+            std::optional<Snapshot> snapshot;
+            uint64_t snapshot_id = 0;
+            bool stop;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                //   -    retry_interval_ms,      
+                bool failing = !error.empty();
+                cv.wait_for(lock, std::chrono::milliseconds(failing ? options.retry_interval_ms : options.flush_interval_ms), [&] {
+                    return stopping || (!failing && (flush_requested || pending_snapshot || pending.size() >= options.batch_points));
+                });
+                flush_requested = false;
+                batch.swap(pending);
+                pending.clear();
+                first_seq = pending_first_seq;
+                pending_first_seq = next_seq;
+                snapshot.swap(pending_snapshot);
+                snapshot_id = snapshots_requested;
+                stop = stopping;
+            }
+
+            size_t done = 0;               //  ,   
+            bool snapshot_done = !snapshot;
+            std::string failure;
+            try {
+                drop_torn_tail();
+                if (snapshot) {
+                    // ,   ,     :  
+                    //  ,   
+                    size_t before = static_cast<size_t>(std::min<uint64_t>(batch.size(), snapshot->seq - first_seq));
+                    write_record(batch.data(), before, first_seq);
+                    done = before;
+                    snapshot->save(snapshot_file);
+                    reset_file(snapshot->seq);
+                    snapshot_done = true;
+                }
+                write_record(batch.data() + done, batch.size() - done, first_seq + done);
+                done = batch.size();
+            } catch (const std::exception& e) {
+                failure = e.what();
+            }
+
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                written_seq = first_seq + done;
+                //  -    ,  ,    
+                if (done < batch.size()) {
+                    pending.insert(pending.begin(), batch.begin() + static_cast<std::ptrdiff_t>(done), batch.end());
+                    pending_first_seq = first_seq + done;
+                }
+                if (snapshot && snapshot_done) snapshots_done = snapshot_id;
+                //   ,      
+                else if (snapshot && !pending_snapshot) pending_snapshot = std::move(snapshot);
+                error = failure;
+            }
+            flushed_cv.notify_all();
+            if (stop) return;
+        }
+    }
+
+    //  :    >= from_seq.   
+    //   ,     . ,   
+    //  from_seq,   lost:    from_seq,  
+    //          (  
+    //   -      ).
+    std::vector<JournalPoint> read_journal(uint64_t from_seq, uint64_t& end_seq, uint64_t& lost) {
+        using namespace JournalFormat;
+        std::vector<JournalPoint> points;
+        std::vector<uint8_t> data = read_file(journal_file);
+        end_seq = from_seq; //    end_seq      points
+        lost = 0;
+
+        JournalHeader h;
+        if (data.size() < sizeof(h)) return points;
+        std::memcpy(&h, data.data(), sizeof(h));
+        if (h.magic != JOURNAL_MAGIC || h.version != VERSION) {
+            throw std::runtime_error("Not a journal file: " + journal_file);
+        }
+        if (h.base_seq > end_seq) {
+            lost += h.base_seq - end_seq;
+            end_seq = h.base_seq;
+        }
+
+        //     pos; false -   
+        auto read_record = [&](size_t pos, RecordHeader& r) {
+            if (data.size() - pos < sizeof(r)) return false;
+            std::memcpy(&r, data.data() + pos, sizeof(r));
+            size_t bytes = static_cast<size_t>(r.count) * sizeof(JournalPoint);
+            if (r.magic != RECORD_MAGIC || bytes > data.size() - pos - sizeof(r)) return false;
+            return fnv1a(data.data() + pos + sizeof(r), bytes) == r.checksum;
+        };
+
+        size_t pos = sizeof(h);
+        RecordHeader r;
+        while (pos < data.size() && read_record(pos, r)) {
+            if (r.first_seq > end_seq) {
+                lost += r.first_seq - end_seq;
+                end_seq = r.first_seq;
+            }
+            const uint8_t* payload = data.data() + pos + sizeof(r);
+            for (uint32_t i = 0; i < r.count; ++i) {
+                if (r.first_seq + i < end_seq) continue; //     
+                JournalPoint p;
+                std::memcpy(&p, payload + i * sizeof(JournalPoint), sizeof(p));
+                points.push_back(p);
+            }
+            end_seq = std::max(end_seq, r.first_seq + r.count);
+            pos += sizeof(r) + r.count * sizeof(JournalPoint);
+        }
+        if (pos < data.size()) {
+            //    :    8 
+            uint64_t last_seq = end_seq;
+            for (size_t scan = pos + 8; scan < data.size(); scan += 8) {
+                if (read_record(scan, r)) last_seq = std::max(last_seq, r.first_seq + r.count);
+            }
+            lost += last_seq - end_seq;
+            if (::truncate(journal_file.c_str(), static_cast<off_t>(pos)) != 0) {
+                throw std::runtime_error("Cannot truncate damaged tail of " + journal_file);
+            }
+        }
+        return points;
+    }
+
+public:
+    // base -   : base.journal  base.snap
+    explicit StateJournal(const std::string& base, const Options& options)
+        : journal_file(base + ".journal"), snapshot_file(base + ".snap"), options(options) {}
+
+    explicit StateJournal(const std::string& base) : StateJournal(base, Options()) {}
+
+    ~StateJournal() {
+        if (writer.joinable()) {
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                stopping = true;
+            }
+            cv.notify_all();
+            writer.join();
+        }
+        if (fd >= 0) ::close(fd);
+    }
+
+    StateJournal(const StateJournal&) = delete;
+    StateJournal& operator=(const StateJournal&) = delete;
+
+    //    .     append().
+    Recovery recover() {
+        using namespace JournalFormat;
+        if (writer.joinable()) throw std::runtime_error("Journal is already open");
+        auto start = std::chrono::steady_clock::now();
+
+        Recovery result;
+        result.has_snapshot = result.snapshot.load(snapshot_file);
+        uint64_t end_seq = result.snapshot.seq;
+        result.tail = read_journal(result.snapshot.seq, end_seq, result.lost);
+
+        fd = ::open(journal_file.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+        if (fd < 0) throw std::runtime_error("Cannot open " + journal_file);
+        struct stat st{};
+        if (fstat(fd, &st) != 0) throw std::runtime_error("Cannot stat " + journal_file);
+        good_size = st.st_size;
+        if (st.st_size < static_cast<off_t>(sizeof(JournalHeader))) reset_file(result.snapshot.seq);
+
+        next_seq = pending_first_seq = written_seq = end_seq;
+        writer = std::thread([this] { writer_loop(); });
+        result.milliseconds = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+        return result;
+    }
+
+    //   :    
+    void append(double x, double y) {
+        bool wake;
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            pending.push_back({x, y});
+            ++next_seq;
+            wake = pending.size() >= options.batch_points;
+        }
+        if (wake) cv.notify_one();
+    }
+
+    //  ,   ,    .
+    //   ; seq  .
+    void checkpoint(Snapshot snapshot) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            snapshot.seq = next_seq;
+            pending_snapshot = std::move(snapshot);
+            ++snapshots_requested;
+        }
+        cv.notify_one();
+    }
+
+    // ,        
+    void flush() {
+        std::unique_lock<std::mutex> lock(mutex);
+        uint64_t target = next_seq;
+        uint64_t snapshot_target = snapshots_requested;
+        flush_requested = true;
+        cv.notify_one();
+        flushed_cv.wait(lock, [&] {
+            return (written_seq >= target && snapshots_done >= snapshot_target) || !error.empty();
+        });
+        if (!error.empty()) throw std::runtime_error(error);
+    }
+
+    uint64_t size() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return next_seq;
+    }
+
+    //       ;  -  
+    //     .    ,    .
+    std::string last_error() {
+        std::lock_guard<std::mutex> lock(mutex);
+        return error;
+    }
+};
@@ -0,0 +1,105 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <utility>
+#include <cstddef>
+#include <cmath>
+
+#include "FitMetrics.h"
+#include "RobustFit.h"
+#include "EventTrace.h"
+
+//     . main2.cpp  prak1_1.cpp   
+//   ,  trace_replay.cpp     ,
+//       ,  .
+
+// main2.cpp:      O(1)    (RobustFit.h)
+namespace Main2Fit {
+    constexpr size_t MAX_POINTS = 1000; //    
+
+    //   :      
+    enum class FitMode { Ols, Ransac, Huber };
+
+    inline const char* mode_name(FitMode mode) {
+        switch (mode) {
+        case FitMode::Ransac: return "RANSAC";
+        case FitMode::Huber: return "Huber";
+        default: return "";
+        }
+    }
+
+    //   "mode"  ; false -  
+    inline bool parse_mode(const std::string& name, FitMode& mode) {
+        if (name == "ols") mode = FitMode::Ols;
+        else if (name == "ransac") mode = FitMode::Ransac;
+        else if (name == "huber") mode = FitMode::Huber;
+        else return false;
+        return true;
+    }
+
+    //     (TraceEvent::Command)  
+    inline TraceCommand trace_command(FitMode mode) {
+        switch (mode) {
+        case FitMode::Ransac: return TraceCommand::ModeRansac;
+        case FitMode::Huber: return TraceCommand::ModeHuber;
+        default: return TraceCommand::ModeOls;
+        }
+    }
+
+    inline FitMode from_trace_command(TraceCommand command) {
+        switch (command) {
+        case TraceCommand::ModeRansac: return FitMode::Ransac;
+        case TraceCommand::ModeHuber: return FitMode::Huber;
+        default: return FitMode::Ols;
+        }
+    }
+
+    //    mode; robust    ,   fit.  -  O(1) 
+    // ,   -     (   
+    //    -  ).  inliers -    ,
+    // 0 -    .
+    inline std::pair<double, double> solve(FitMode mode, const FitTracker& fit, RobustRegressor& robust, size_t* inliers = nullptr) {
+        if (inliers) *inliers = 0;
+        if (mode == FitMode::Ols || robust.size() < 3) return fit.solve();
+        RobustResult result = mode == FitMode::Ransac ? robust.fit_ransac() : robust.fit_huber();
+        if (!result.valid) return fit.solve();
+        if (inliers) *inliers = result.inliers;
+        return {result.m, result.b};
+    }
+}
+
+// prak1_1.cpp:     ,    
+//    TRAINING_EPOCHS    
+namespace Prak1Fit {
+    constexpr int FIXED_POINT_BITS = 10;
+    constexpr double LEARNING_RATE = 0.01;
+    constexpr int TRAINING_EPOCHS = 500;
+    constexpr long long SCALE = 1LL << FIXED_POINT_BITS;
+
+    inline long long to_fixed(double value) { return static_cast<long long>(std::round(value * SCALE)); }
+    inline double from_fixed(long long fixed_value) { return static_cast<double>(fixed_value) / SCALE; }
+
+    //    ;  -      x  y
+    template<typename Points>
+    void train(const Points& points, long long& slope_fixed, long long& intercept_fixed) {
+        slope_fixed = 0;
+        intercept_fixed = 0;
+        const long long learning_rate_fixed = to_fixed(LEARNING_RATE);
+
+        for (int epoch = 0; epoch < TRAINING_EPOCHS; ++epoch) {
+            for (const auto& point : points) {
+                long long x_fixed = to_fixed(point.x);
+                long long y_fixed = to_fixed(point.y);
+
+                long long y_pred_fixed = ((slope_fixed * x_fixed) >> FIXED_POINT_BITS) + intercept_fixed;
+                long long error_fixed = y_pred_fixed - y_fixed;
+
+                long long grad_slope = (error_fixed * x_fixed) >> FIXED_POINT_BITS;
+                long long grad_intercept = error_fixed;
+
+                slope_fixed -= (learning_rate_fixed * grad_slope) >> FIXED_POINT_BITS;
+                intercept_fixed -= (learning_rate_fixed * grad_intercept) >> FIXED_POINT_BITS;
+            }
+        }
+    }
+}
@@ -0,0 +1,69 @@
+#pragma once
+#include <utility>
+#include <cstdint>
+
+//     y = m*x + b    .
+//   :   - 56 ,   - O(1).  
+//    (   ),   
+//    ,     x^2  x*y " ".
+//    Trainer::calculate_weights_normal_equation.
+struct LineStats {
+    uint64_t count = 0;   //  
+    double weight = 0.0;  //    (    count)
+    double mean_x = 0.0;
+    double mean_y = 0.0;
+    double sxx = 0.0;     // sum w*(x - mean_x)^2
+    double sxy = 0.0;     // sum w*(x - mean_x)*(y - mean_y)
+    double syy = 0.0;     // sum w*(y - mean_y)^2
+
+    void add(double x, double y, double w = 1.0) {
+        if (w <= 0.0) return;
+        ++count;
+        weight += w;
+        double dx = x - mean_x;
+        double dy = y - mean_y;
+        double k = w / weight;
+        mean_x += dx * k;
+        mean_y += dy * k;
+        //        
+        sxx += w * dx * (x - mean_x);
+        sxy += w * dx * (y - mean_y);
+        syy += w * dy * (y - mean_y);
+    }
+
+    //      
+    void merge(const LineStats& other) {
+        if (other.weight <= 0.0) return;
+        if (weight <= 0.0) {
+            *this = other;
+            return;
+        }
+        double total = weight + other.weight;
+        double dx = other.mean_x - mean_x;
+        double dy = other.mean_y - mean_y;
+        double f = weight * other.weight / total;
+        sxx += other.sxx + dx * dx * f;
+        sxy += other.sxy + dx * dy * f;
+        syy += other.syy + dy * dy * f;
+        mean_x += dx * other.weight / total;
+        mean_y += dy * other.weight / total;
+        weight = total;
+        count += other.count;
+    }
+
+    void reset() { *this = LineStats(); }
+
+    //  X^T*X  : weight * sxx
+    double determinant() const { return weight * sxx; }
+
+    //   (     x ) -   , 
+    //   Matrix::inverse_2x2
+    bool solvable() const { return count >= 2 && determinant() >= 1e-9; }
+
+    //  [m, b];    - ,   Trainer
+    std::pair<double, double> solve() const {
+        if (!solvable()) return {0.0, 0.0};
+        double m = sxy / sxx;
+        return {m, mean_y - m * mean_x};
+    }
+};
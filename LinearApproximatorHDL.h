@@ -0,0 +1,41 @@
+#pragma once
+#include <utility>
+#include <cmath>
+
+//       (  prak1.cpp,
+//      ApproximatorBank.h,   ).
+constexpr int FIXED_POINT_BITS = 10;
+constexpr long long SCALE = 1LL << FIXED_POINT_BITS;
+constexpr long long LEARNING_RATE_FIXED = static_cast<long long>(0.01 * SCALE);
+inline long long double_to_fixed(double val) { return static_cast<long long>(round(val * SCALE)); }
+inline double fixed_to_double(long long fixed_val) { return static_cast<double>(fixed_val) / SCALE; }
+
+class LinearApproximatorHDL {
+private:
+    long long m_fixed;
+    long long b_fixed;
+public:
+    LinearApproximatorHDL() : m_fixed(0), b_fixed(0) {}
+    void reset() { m_fixed = 0; b_fixed = 0; }
+
+    //        (m, b).  
+    // ,      RTL.     
+    // update(),   ,     .
+    static void step(long long& m_fixed, long long& b_fixed, long long x_fixed, long long y_fixed) {
+        long long product = m_fixed * x_fixed;
+        long long y_pred_fixed = (product >> FIXED_POINT_BITS) + b_fixed;
+        long long error_fixed = y_pred_fixed - y_fixed;
+        long long grad_m_fixed = (error_fixed * x_fixed) >> FIXED_POINT_BITS;
+        long long grad_b_fixed = error_fixed;
+        long long m_update = (LEARNING_RATE_FIXED * grad_m_fixed) >> FIXED_POINT_BITS;
+        long long b_update = (LEARNING_RATE_FIXED * grad_b_fixed) >> FIXED_POINT_BITS;
+        m_fixed -= m_update;
+        b_fixed -= b_update;
+    }
+
+    void update(long long x_fixed, long long y_fixed) { step(m_fixed, b_fixed, x_fixed, y_fixed); }
+
+    std::pair<double, double> getCoeffsDouble() const { return {fixed_to_double(m_fixed), fixed_to_double(b_fixed)}; }
+    std::pair<long long, long long> getCoeffsFixed() const { return {m_fixed, b_fixed}; }
+    void setCoeffsFixed(long long m, long long b) { m_fixed = m; b_fixed = b; }
+};
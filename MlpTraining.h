@@ -0,0 +1,262 @@
+#pragma once
+#include <vector>
+#include <random>
+#include <fstream>
+#include <string>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+
+#include "WeightBundle.h"
+#include "QuantizedMlp.h"
+
+//   6 -> 32 -> 16 -> 2  й1:  ,   ,
+// ,      .   generate_weights.cpp
+//  sweep_weights.cpp. Matrix<T>  - ,   Matrix  Matrix.h
+// (Trainer.h)      .
+
+// --- Matrix struct and functions ---
+// T -     (double  float), Acc - ,    
+//  ( float - float  double).      
+// ,    i-k-j    axpy   .
+template<typename T>
+struct Matrix { size_t r,c; std::vector<T> d; Matrix(size_t R=0,size_t C=0):r(R),c(C),d(R*C,T(0)){} void randomize(unsigned int s){std::mt19937 g(s);std::uniform_real_distribution<> u(-1.,1.);for(auto&v:d)v=static_cast<T>(u(g)*std::sqrt(2.0/(r+c)));} T& at(size_t R,size_t C){return d[R*c+C];} const T& at(size_t R,size_t C)const{return d[R*c+C];} };
+
+// y += a*x.         ,   
+//     ( float      )
+template<size_t N,typename Acc,typename T> inline void axpy_fixed(Acc* __restrict y,Acc a,const T* __restrict x){for(size_t j=0;j<N;++j)y[j]+=a*static_cast<Acc>(x[j]);}
+template<typename Acc,typename T> inline void axpy(Acc* __restrict y,Acc a,const T* __restrict x,size_t n){
+    switch(n){
+    case 32:axpy_fixed<32>(y,a,x);break;
+    case 16:axpy_fixed<16>(y,a,x);break;
+    case 2:axpy_fixed<2>(y,a,x);break;
+    default:for(size_t j=0;j<n;++j)y[j]+=a*static_cast<Acc>(x[j]);
+    }
+}
+
+// r = a*b + bias.  a(i,k) ( ReLU  ) .
+template<typename T,typename Acc> void multiply_add_bias(const Matrix<T>&a,const Matrix<T>&b,const Matrix<T>&bias,Matrix<T>&r,std::vector<Acc>&row){
+    row.resize(b.c);
+    for(size_t i=0;i<a.r;++i){
+        std::fill(row.begin(),row.end(),Acc(0));
+        for(size_t k=0;k<a.c;++k){Acc aik=a.at(i,k);if(aik!=Acc(0))axpy(row.data(),aik,&b.d[k*b.c],b.c);}
+        for(size_t j=0;j<b.c;++j)r.at(i,j)=static_cast<T>(row[j])+bias.d[j];
+    }
+}
+// r = a^T * b ( ):    
+template<typename T,typename Acc> void multiply_tn(const Matrix<T>&a,const Matrix<T>&b,Matrix<T>&r,std::vector<Acc>&acc){
+    acc.assign(a.c*b.c,Acc(0));
+    for(size_t i=0;i<a.r;++i)for(size_t k=0;k<a.c;++k){Acc aik=a.at(i,k);if(aik!=Acc(0))axpy(&acc[k*b.c],aik,&b.d[i*b.c],b.c);}
+    for(size_t i=0;i<acc.size();++i)r.d[i]=static_cast<T>(acc[i]);
+}
+// r = a * bt^T,  bt -    (bt = transpose(b))
+template<typename T,typename Acc> void multiply_nt(const Matrix<T>&a,const Matrix<T>&bt,Matrix<T>&r,std::vector<Acc>&row){
+    row.resize(bt.c);
+    for(size_t i=0;i<a.r;++i){
+        std::fill(row.begin(),row.end(),Acc(0));
+        for(size_t j=0;j<a.c;++j)axpy(row.data(),static_cast<Acc>(a.at(i,j)),&bt.d[j*bt.c],bt.c);
+        for(size_t k=0;k<bt.c;++k)r.at(i,k)=static_cast<T>(row[k]);
+    }
+}
+template<typename T> void apply_relu(const Matrix<T>&m,Matrix<T>&r){for(size_t i=0;i<m.d.size();++i)r.d[i]=std::max(T(0),m.d[i]);}
+// dZ = dA * relu'(Z)
+template<typename T> void relu_backward(const Matrix<T>&dA,const Matrix<T>&Z,Matrix<T>&dZ){for(size_t i=0;i<Z.d.size();++i)dZ.d[i]=Z.d[i]>T(0)?dA.d[i]:T(0);}
+template<typename T> void transpose(const Matrix<T>&m,Matrix<T>&r){for(size_t i=0;i<m.r;++i)for(size_t j=0;j<m.c;++j)r.at(j,i)=m.at(i,j);}
+template<typename T,typename Acc> void sum_rows(const Matrix<T>&m,Matrix<T>&r,std::vector<Acc>&row){row.assign(m.c,Acc(0));for(size_t i=0;i<m.r;++i)for(size_t j=0;j<m.c;++j)row[j]+=static_cast<Acc>(m.at(i,j));for(size_t j=0;j<m.c;++j)r.d[j]=static_cast<T>(row[j]);}
+
+const size_t NUM_POINTS = 3, INPUT_SIZE=NUM_POINTS*2, HIDDEN1_SIZE=32, HIDDEN2_SIZE=16, OUTPUT_SIZE=2;
+const double M_B_MIN=-5.0, M_B_MAX=5.0;
+const double X_MIN=-10.0, X_MAX=10.0;
+const double Y_MIN=M_B_MIN*X_MIN+M_B_MIN, Y_MAX=M_B_MAX*X_MAX+M_B_MAX;
+const int64_t SCALE_FACTOR = 100000; //  
+
+template<typename T> struct Network { Matrix<T> W1,B1,W2,B2,W3,B3; };
+
+//  :   seed, seed+1, ... seed+5 (  1..6,   й1).
+//    ,  .
+template<typename T> void init_network(Network<T>& n,unsigned int seed=1){
+    n.W1.randomize(seed);n.B1.randomize(seed+1);n.W2.randomize(seed+2);n.B2.randomize(seed+3);n.W3.randomize(seed+4);n.B3.randomize(seed+5);
+}
+
+template<typename T> Network<T> make_network(unsigned int seed=1){
+    Network<T> n{Matrix<T>(INPUT_SIZE,HIDDEN1_SIZE),Matrix<T>(1,HIDDEN1_SIZE),Matrix<T>(HIDDEN1_SIZE,HIDDEN2_SIZE),Matrix<T>(1,HIDDEN2_SIZE),Matrix<T>(HIDDEN2_SIZE,OUTPUT_SIZE),Matrix<T>(1,OUTPUT_SIZE)};
+    init_network(n,seed);
+    return n;
+}
+
+//   : 1 -  , 0 - .   -  .
+template<typename T> struct PruneMasks { Matrix<T> W1,W2,W3; bool empty()const{return W1.d.empty();} };
+
+template<typename T> void apply_masks(Network<T>& n,const PruneMasks<T>& m){if(m.empty())return;for(size_t i=0;i<n.W1.d.size();++i)n.W1.d[i]*=m.W1.d[i];for(size_t i=0;i<n.W2.d.size();++i)n.W2.d[i]*=m.W2.d[i];for(size_t i=0;i<n.W3.d.size();++i)n.W3.d[i]*=m.W3.d[i];}
+
+//   :      
+template<typename T,typename Acc> struct Workspace {
+    Matrix<T> Z1,A1,Z2,A2,Z3,dZ1,dZ2,dZ3,dA1,dA2,dW1,dW2,dW3,dB1,dB2,dB3,W2t,W3t;
+    std::vector<Acc> acc;
+    explicit Workspace(size_t batch):Z1(batch,HIDDEN1_SIZE),A1(batch,HIDDEN1_SIZE),Z2(batch,HIDDEN2_SIZE),A2(batch,HIDDEN2_SIZE),Z3(batch,OUTPUT_SIZE),
+        dZ1(batch,HIDDEN1_SIZE),dZ2(batch,HIDDEN2_SIZE),dZ3(batch,OUTPUT_SIZE),dA1(batch,HIDDEN1_SIZE),dA2(batch,HIDDEN2_SIZE),
+        dW1(INPUT_SIZE,HIDDEN1_SIZE),dW2(HIDDEN1_SIZE,HIDDEN2_SIZE),dW3(HIDDEN2_SIZE,OUTPUT_SIZE),dB1(1,HIDDEN1_SIZE),dB2(1,HIDDEN2_SIZE),dB3(1,OUTPUT_SIZE),
+        W2t(HIDDEN2_SIZE,HIDDEN1_SIZE),W3t(OUTPUT_SIZE,HIDDEN2_SIZE){}
+};
+
+template<typename T,typename Acc> void forward(const Network<T>& n,const Matrix<T>& X,Workspace<T,Acc>& w){
+    multiply_add_bias(X,n.W1,n.B1,w.Z1,w.acc);apply_relu(w.Z1,w.A1);
+    multiply_add_bias(w.A1,n.W2,n.B2,w.Z2,w.acc);apply_relu(w.Z2,w.A2);
+    multiply_add_bias(w.A2,n.W3,n.B3,w.Z3,w.acc);
+}
+
+//    ;      .    .
+template<typename T,typename Acc> double train_step(Network<T>& n,const Matrix<T>& X_batch,const Matrix<T>& Y_batch,double learning_rate,const PruneMasks<T>& masks,Workspace<T,Acc>& w) {
+    size_t batch_size=X_batch.r;
+    forward(n,X_batch,w);
+    for(size_t i=0;i<w.dZ3.d.size();++i)w.dZ3.d[i]=w.Z3.d[i]-Y_batch.d[i];
+    Acc loss=0;for(T e:w.dZ3.d)loss+=static_cast<Acc>(e)*e;
+    multiply_tn(w.A2,w.dZ3,w.dW3,w.acc);sum_rows(w.dZ3,w.dB3,w.acc);transpose(n.W3,w.W3t);multiply_nt(w.dZ3,w.W3t,w.dA2,w.acc);
+    relu_backward(w.dA2,w.Z2,w.dZ2);multiply_tn(w.A1,w.dZ2,w.dW2,w.acc);sum_rows(w.dZ2,w.dB2,w.acc);transpose(n.W2,w.W2t);multiply_nt(w.dZ2,w.W2t,w.dA1,w.acc);
+    relu_backward(w.dA1,w.Z1,w.dZ1);multiply_tn(X_batch,w.dZ1,w.dW1,w.acc);sum_rows(w.dZ1,w.dB1,w.acc);
+    const T lr=static_cast<T>(learning_rate),N=static_cast<T>(batch_size);
+    for(size_t i=0;i<n.W1.d.size();++i){n.W1.d[i]-=lr*w.dW1.d[i]/N;} for(size_t i=0;i<n.B1.d.size();++i){n.B1.d[i]-=lr*w.dB1.d[i]/N;}
+    for(size_t i=0;i<n.W2.d.size();++i){n.W2.d[i]-=lr*w.dW2.d[i]/N;} for(size_t i=0;i<n.B2.d.size();++i){n.B2.d[i]-=lr*w.dB2.d[i]/N;}
+    for(size_t i=0;i<n.W3.d.size();++i){n.W3.d[i]-=lr*w.dW3.d[i]/N;} for(size_t i=0;i<n.B3.d.size();++i){n.B3.d[i]-=lr*w.dB3.d[i]/N;}
+    apply_masks(n,masks);
+    return loss;
+}
+
+// ---  ---
+//  - PRUNE_BLOCK    ,   SparseMlp:  
+//         w*.mem.
+const size_t PRUNE_BLOCK = 4;
+
+//   RMS    
+template<typename T> void prune_blocks(const Matrix<T>& W,Matrix<T>& mask,double threshold){
+    for(size_t i=0;i<W.r;++i)for(size_t c=0;c<W.c;c+=PRUNE_BLOCK){
+        size_t end=std::min(W.c,c+PRUNE_BLOCK);double ss=0;
+        for(size_t j=c;j<end;++j)ss+=static_cast<double>(W.at(i,j))*W.at(i,j);
+        if(std::sqrt(ss/(end-c))<threshold)for(size_t j=c;j<end;++j)mask.at(i,j)=T(0);
+    }
+}
+
+//        relu(b):    
+//   .        .   .
+template<typename T> void remove_dead_neurons(Matrix<T>& W,Matrix<T>& B,Matrix<T>& mask,Matrix<T>& W_next,Matrix<T>& B_next,Matrix<T>& mask_next){
+    for(size_t j=0;j<W.c;++j){
+        bool no_in=true,no_out=true;
+        for(size_t i=0;i<W.r;++i)if(mask.at(i,j)!=T(0))no_in=false;
+        for(size_t k=0;k<W_next.c;++k)if(mask_next.at(j,k)!=T(0))no_out=false;
+        if(no_in&&!no_out){
+            T a=std::max(T(0),B.at(0,j));
+            for(size_t k=0;k<W_next.c;++k){B_next.at(0,k)+=a*W_next.at(j,k);mask_next.at(j,k)=T(0);}
+            no_out=true;
+        }
+        if(no_out){for(size_t i=0;i<W.r;++i)mask.at(i,j)=T(0);B.at(0,j)=T(0);}
+    }
+}
+
+template<typename T> PruneMasks<T> prune_network(Network<T>& n,double threshold){
+    PruneMasks<T> m{Matrix<T>(n.W1.r,n.W1.c),Matrix<T>(n.W2.r,n.W2.c),Matrix<T>(n.W3.r,n.W3.c)};
+    for(auto* mask:{&m.W1,&m.W2,&m.W3})std::fill(mask->d.begin(),mask->d.end(),T(1));
+    prune_blocks(n.W1,m.W1,threshold);prune_blocks(n.W2,m.W2,threshold);prune_blocks(n.W3,m.W3,threshold);
+    //         -  
+    for(int pass=0;pass<2;++pass){
+        apply_masks(n,m);
+        remove_dead_neurons(n.W1,n.B1,m.W1,n.W2,n.B2,m.W2);
+        remove_dead_neurons(n.W2,n.B2,m.W2,n.W3,n.B3,m.W3);
+    }
+    apply_masks(n,m);
+    return m;
+}
+
+//        -    SparseMlp::macs()
+template<typename T> size_t count_macs(const Network<T>& n){
+    size_t macs=0;
+    for(const Matrix<T>* W:{&n.W1,&n.W2,&n.W3})for(size_t i=0;i<W->r;++i)for(size_t c=0;c<W->c;c+=PRUNE_BLOCK){
+        size_t end=std::min(W->c,c+PRUNE_BLOCK);bool zero=true;
+        for(size_t j=c;j<end;++j)if(W->at(i,j)!=T(0))zero=false;
+        if(!zero)macs+=end-c;
+    }
+    return macs;
+}
+
+// ---    ---
+template<typename T> std::vector<BundleLayerData> quantize_network(const Network<T>& n){
+    auto quantize_layer=[](const Matrix<T>& W,const Matrix<T>& B){
+        BundleLayerData layer;layer.inputs=static_cast<uint32_t>(W.r);layer.outputs=static_cast<uint32_t>(W.c);
+        for(T v:W.d)layer.weights.push_back(static_cast<int32_t>(std::round(static_cast<double>(v)*SCALE_FACTOR)));
+        for(T v:B.d)layer.bias.push_back(static_cast<int32_t>(std::round(static_cast<double>(v)*SCALE_FACTOR)));
+        return layer;
+    };
+    return {quantize_layer(n.W1,n.B1),quantize_layer(n.W2,n.B2),quantize_layer(n.W3,n.B3)};
+}
+
+const BundleRanges RANGES{X_MIN,X_MAX,Y_MIN,Y_MAX,M_B_MIN,M_B_MAX,{}};
+
+//  :  ,    ,   double
+struct EvalSet { Matrix<double> X,Y; };
+
+//    m  b   :     
+//      (   )
+struct Accuracy { double m=0,b=0,q_m=0,q_b=0; };
+
+//    {m, b}    
+inline std::vector<double> quantized_predictions(const std::vector<BundleLayerData>& layers,const EvalSet& eval){
+    QuantizedMlp q;q.load_layers(SCALE_FACTOR,RANGES,layers);
+    std::vector<double> result(eval.X.r*OUTPUT_SIZE);
+    int32_t coords[INPUT_SIZE],out[OUTPUT_SIZE];
+    for(size_t i=0;i<eval.X.r;++i){
+        for(size_t p=0;p<NUM_POINTS;++p){
+            coords[p*2]=q.to_fixed((eval.X.at(i,p*2)+1.0)/2.0*(X_MAX-X_MIN)+X_MIN);
+            coords[p*2+1]=q.to_fixed((eval.X.at(i,p*2+1)+1.0)/2.0*(Y_MAX-Y_MIN)+Y_MIN);
+        }
+        q.infer(coords,out);
+        result[i*2]=q.from_fixed(out[0]);result[i*2+1]=q.from_fixed(out[1]);
+    }
+    return result;
+}
+
+template<typename T,typename Acc> Accuracy evaluate(const Network<T>& n,const EvalSet& eval){
+    Accuracy acc;
+    double mb_half=(M_B_MAX-M_B_MIN)/2.0;
+    Matrix<T> X(eval.X.r,INPUT_SIZE);std::copy(eval.X.d.begin(),eval.X.d.end(),X.d.begin());
+    Workspace<T,Acc> w(eval.X.r);forward(n,X,w);
+    std::vector<double> q=quantized_predictions(quantize_network(n),eval);
+    for(size_t i=0;i<eval.X.r;++i){
+        double true_m=(eval.Y.at(i,0)+1.0)*mb_half+M_B_MIN,true_b=(eval.Y.at(i,1)+1.0)*mb_half+M_B_MIN;
+        acc.m+=std::abs(w.Z3.at(i,0)-eval.Y.at(i,0))*mb_half;acc.b+=std::abs(w.Z3.at(i,1)-eval.Y.at(i,1))*mb_half;
+        acc.q_m+=std::abs(q[i*2]-true_m);acc.q_b+=std::abs(q[i*2+1]-true_b);
+    }
+    double N=static_cast<double>(eval.X.r);
+    acc.m/=N;acc.b/=N;acc.q_m/=N;acc.q_b/=N;
+    return acc;
+}
+
+// network_weights.txt  RTL  й2       network_weights.nwb (WeightBundle.h)
+inline void save_weights(const std::vector<BundleLayerData>& quantized){
+    std::ofstream outfile("network_weights.txt");
+    outfile << SCALE_FACTOR << "\n";
+    outfile << X_MIN << " " << X_MAX << "\n";
+    outfile << Y_MIN << " " << Y_MAX << "\n";
+    outfile << M_B_MIN << " " << M_B_MAX << "\n";
+    
+    auto save_quantized_matrix = [&](size_t r, size_t c, const std::vector<int32_t>& data) {
+        outfile << r << " " << c << "\n";
+        for (size_t i = 0; i < r; ++i) {
+            for (size_t j = 0; j < c; ++j) {
+                outfile << data[i * c + j] << (j == c - 1 ? "" : " ");
+            }
+            outfile << "\n";
+        }
+    };
+    
+    for (const auto& layer : quantized) {
+        save_quantized_matrix(layer.inputs, layer.outputs, layer.weights);
+        save_quantized_matrix(1, layer.outputs, layer.bias);
+    }
+    
+    outfile.close();
+
+    WeightBundle::write("network_weights.nwb", SCALE_FACTOR, RANGES, quantized);
+}
+
+//  : double -  ; float -     float,  
+//  float  (mixed)  double
+enum class Precision { Double, Float, Mixed };
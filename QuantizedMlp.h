@@ -0,0 +1,330 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <string>
+#include <memory>
+#include <fstream>
+#include <stdexcept>
+#include <cstdint>
+#include <cmath>
+#include <algorithm>
+
+#include "WeightBundle.h"
+
+//   .    ,   w*.mem  $readmemh:
+// row-major [][], ..   (i -> j)    i * outputs + j.
+struct QuantizedLayer {
+    uint32_t inputs = 0;
+    uint32_t outputs = 0;
+    const int32_t* weights = nullptr;
+    const int32_t* bias = nullptr;
+};
+
+//    6 -> 32 -> 16 -> 2   .
+//    neural_inference --: 32- ,
+// 64- ,   SCALE, , ReLU   
+//     32 .      .
+class QuantizedMlp {
+public:
+    static constexpr size_t INPUT_SIZE = 6;
+    static constexpr size_t OUTPUT_SIZE = 2;
+
+    //     SCALE:
+    // Divide        - "/ SCALE"     ( 3, neural_inference_old1)
+    // InvScaleShift -   INV_SCALE    32 ( 4,  )
+    enum class ScaleMode { Divide, InvScaleShift };
+
+private:
+    std::vector<QuantizedLayer> layers;
+    std::vector<int32_t> storage; //  ,     
+    std::shared_ptr<const WeightBundle> bundle; // ...     
+
+    int64_t scale = 100000;
+    int64_t inv_scale = 42950;
+    ScaleMode scale_mode = ScaleMode::Divide;
+
+    //     fixed-point (  neural_weights.vh)
+    int64_t x_min_fp = 0, x_half_range = 1;
+    int64_t y_min_fp = 0, y_half_range = 1;
+    int64_t mb_min_fp = 0, mb_half_range = 1;
+    BundleRanges ranges{};
+
+    int64_t scale_acc(int64_t acc) const {
+        if (scale_mode == ScaleMode::Divide) return acc / scale;
+        return static_cast<int64_t>((static_cast<__int128>(acc) * inv_scale) >> 32);
+    }
+
+    // normalize_x / normalize_y: 2*(v - min)/(max - min) - 1  =>  (v - min_fp) / half_range - SCALE
+    int32_t normalize(int32_t val, int64_t min_fp, int64_t half_range) const {
+        int64_t temp = (static_cast<int64_t>(val) - min_fp) / half_range - scale;
+        return static_cast<int32_t>(temp);
+    }
+
+    // denormalize_mb: (v + 1) * half_range + min  =>  (v_fp + SCALE) * half_range + MB_MIN_FP
+    int32_t denormalize(int32_t val) const {
+        int64_t temp = (static_cast<int64_t>(val) + scale) * mb_half_range + mb_min_fp;
+        return static_cast<int32_t>(temp);
+    }
+
+    void run_layer(const QuantizedLayer& layer, const int32_t* in, int32_t* out, bool relu) const {
+        for (uint32_t j = 0; j < layer.outputs; ++j) {
+            int64_t acc = 0;
+            for (uint32_t i = 0; i < layer.inputs; ++i) {
+                acc += static_cast<int64_t>(in[i]) * layer.weights[i * layer.outputs + j];
+            }
+            out[j] = activate(acc, layer.bias[j], relu);
+        }
+    }
+
+    //   load_text  load_layers:    storage
+    void attach_storage(const std::vector<std::pair<size_t, size_t>>& shapes) {
+        bundle.reset();
+        layers.clear();
+        size_t offset = 0;
+        for (const auto& [inputs, outputs] : shapes) {
+            QuantizedLayer layer;
+            layer.inputs = static_cast<uint32_t>(inputs);
+            layer.outputs = static_cast<uint32_t>(outputs);
+            layer.weights = storage.data() + offset;
+            offset += inputs * outputs;
+            layer.bias = storage.data() + offset;
+            offset += outputs;
+            layers.push_back(layer);
+        }
+        validate();
+    }
+
+public:
+    void set_scale_mode(ScaleMode mode) { scale_mode = mode; }
+
+    //      (   )
+    void set_ranges(int64_t scale_factor, double x_min, double x_max, double y_min, double y_max, double mb_min, double mb_max) {
+        if (scale_factor <= 0) throw std::runtime_error("Invalid scale factor");
+        scale = scale_factor;
+        ranges = BundleRanges{x_min, x_max, y_min, y_max, mb_min, mb_max, {}};
+        inv_scale = static_cast<int64_t>(std::llround(4294967296.0 / static_cast<double>(scale)));
+        x_min_fp = std::llround(x_min * scale);
+        y_min_fp = std::llround(y_min * scale);
+        mb_min_fp = std::llround(mb_min * scale);
+        x_half_range = std::llround((x_max - x_min) / 2.0);
+        y_half_range = std::llround((y_max - y_min) / 2.0);
+        mb_half_range = std::llround((mb_max - mb_min) / 2.0);
+        if (x_half_range == 0 || y_half_range == 0 || mb_half_range == 0) {
+            throw std::runtime_error("Normalization ranges are too narrow for integer arithmetic");
+        }
+    }
+
+    //    network_weights.txt ( й1)
+    void load_text(const std::string& filename) {
+        std::ifstream infile(filename);
+        if (!infile) throw std::runtime_error("Cannot open weights file: " + filename);
+
+        int64_t scale_factor;
+        double x_min, x_max, y_min, y_max, mb_min, mb_max;
+        infile >> scale_factor >> x_min >> x_max >> y_min >> y_max >> mb_min >> mb_max;
+        if (!infile) throw std::runtime_error("Malformed weights header: " + filename);
+        set_ranges(scale_factor, x_min, x_max, y_min, y_max, mb_min, mb_max);
+
+        //  : W1, B1, W2, B2, W3, B3
+        std::vector<std::pair<size_t, size_t>> shapes;
+        std::vector<int32_t> values;
+        for (int m = 0; m < 6; ++m) {
+            size_t r, c;
+            if (!(infile >> r >> c)) throw std::runtime_error("Malformed matrix header in " + filename);
+            shapes.push_back({r, c});
+            for (size_t i = 0; i < r * c; ++i) {
+                int64_t v;
+                if (!(infile >> v)) throw std::runtime_error("Truncated matrix data in " + filename);
+                values.push_back(static_cast<int32_t>(v));
+            }
+        }
+
+        std::vector<std::pair<size_t, size_t>> layer_shapes;
+        for (int l = 0; l < 3; ++l) {
+            auto [wr, wc] = shapes[l * 2];
+            auto [br, bc] = shapes[l * 2 + 1];
+            if (br != 1 || bc != wc) throw std::runtime_error("Bias shape does not match weights in " + filename);
+            layer_shapes.push_back({wr, wc});
+        }
+        storage = std::move(values);
+        attach_storage(layer_shapes);
+    }
+
+    //     (,      )
+    void load_layers(int64_t scale_factor, const BundleRanges& r, const std::vector<BundleLayerData>& data) {
+        set_ranges(scale_factor, r.x_min, r.x_max, r.y_min, r.y_max, r.mb_min, r.mb_max);
+        std::vector<std::pair<size_t, size_t>> shapes;
+        std::vector<int32_t> values;
+        for (const auto& layer : data) {
+            if (layer.weights.size() != static_cast<size_t>(layer.inputs) * layer.outputs || layer.bias.size() != layer.outputs) {
+                throw std::runtime_error("Layer data does not match its shape");
+            }
+            shapes.push_back({layer.inputs, layer.outputs});
+            values.insert(values.end(), layer.weights.begin(), layer.weights.end());
+            values.insert(values.end(), layer.bias.begin(), layer.bias.end());
+        }
+        storage = std::move(values);
+        attach_storage(shapes);
+    }
+
+    //    :      
+    void load_bundle(std::shared_ptr<const WeightBundle> source) {
+        const BundleHeader& h = source->header();
+        const BundleRanges& r = source->ranges();
+        set_ranges(h.scale, r.x_min, r.x_max, r.y_min, r.y_max, r.mb_min, r.mb_max);
+
+        std::vector<QuantizedLayer> mapped;
+        for (uint32_t l = 0; l < source->layer_count(); ++l) {
+            QuantizedLayer layer;
+            layer.inputs = source->layer(l).inputs;
+            layer.outputs = source->layer(l).outputs;
+            layer.weights = source->weights(l);
+            layer.bias = source->bias(l);
+            mapped.push_back(layer);
+        }
+        layers = std::move(mapped);
+        storage.clear();
+        bundle = std::move(source);
+        validate();
+    }
+
+    void load_bundle(const std::string& filename) {
+        load_bundle(std::make_shared<const WeightBundle>(filename));
+    }
+
+    //    : *.nwb - ,   network_weights.txt
+    void load(const std::string& filename) {
+        if (filename.size() > 4 && filename.compare(filename.size() - 4, 4, ".nwb") == 0) load_bundle(filename);
+        else load_text(filename);
+    }
+
+    //    ,   WeightBundle::write
+    std::vector<BundleLayerData> export_layers() const {
+        std::vector<BundleLayerData> result;
+        for (const auto& layer : layers) {
+            BundleLayerData data;
+            data.inputs = layer.inputs;
+            data.outputs = layer.outputs;
+            data.weights.assign(layer.weights, layer.weights + static_cast<size_t>(layer.inputs) * layer.outputs);
+            data.bias.assign(layer.bias, layer.bias + layer.outputs);
+            result.push_back(std::move(data));
+        }
+        return result;
+    }
+
+    BundleRanges export_ranges() const { return ranges; }
+
+    void validate() const {
+        if (layers.empty()) throw std::runtime_error("Network has no layers");
+        if (layers.front().inputs != INPUT_SIZE) throw std::runtime_error("Input layer must have 6 inputs");
+        if (layers.back().outputs != OUTPUT_SIZE) throw std::runtime_error("Output layer must have 2 outputs");
+        for (size_t l = 1; l < layers.size(); ++l) {
+            if (layers[l].inputs != layers[l - 1].outputs) throw std::runtime_error("Layer dimensions mismatch");
+        }
+    }
+
+    const std::vector<QuantizedLayer>& get_layers() const { return layers; }
+
+    //     (  )
+    size_t max_width() const {
+        size_t width = INPUT_SIZE;
+        for (const auto& layer : layers) width = std::max<size_t>(width, layer.outputs);
+        return width;
+    }
+
+    int64_t get_scale() const { return scale; }
+    ScaleMode get_scale_mode() const { return scale_mode; }
+
+    //    fixed-point,    RTL (neural_weights.vh) -
+    //  ,       (StaticMlp.h)
+    struct FixedPointConstants {
+        int64_t scale;
+        int64_t inv_scale;
+        int64_t x_min_fp, x_half_range;
+        int64_t y_min_fp, y_half_range;
+        int64_t mb_min_fp, mb_half_range;
+    };
+
+    FixedPointConstants fixed_point_constants() const {
+        return {scale, inv_scale, x_min_fp, x_half_range, y_min_fp, y_half_range, mb_min_fp, mb_half_range};
+    }
+
+    int32_t to_fixed(double value) const { return static_cast<int32_t>(std::llround(value * scale)); }
+    double from_fixed(int32_t value) const { return static_cast<double>(value) / static_cast<double>(scale); }
+
+    //     -        (SparseMlp.h)
+
+    // coords = {x1, y1, x2, y2, x3, y3}  fixed-point ->   
+    void normalize_inputs(const int32_t* coords, int32_t* a) const {
+        a[0] = normalize(coords[0], x_min_fp, x_half_range);
+        a[1] = normalize(coords[1], y_min_fp, y_half_range);
+        a[2] = normalize(coords[2], x_min_fp, x_half_range);
+        a[3] = normalize(coords[3], y_min_fp, y_half_range);
+        a[4] = normalize(coords[4], x_min_fp, x_half_range);
+        a[5] = normalize(coords[5], y_min_fp, y_half_range);
+    }
+
+    //    -> {m, b}  fixed-point
+    void denormalize_outputs(const int32_t* a, int32_t* out) const {
+        out[0] = denormalize(a[0]);
+        out[1] = denormalize(a[1]);
+    }
+
+    //   -> : , , ReLU,   32 
+    int32_t activate(int64_t acc, int32_t bias, bool relu) const {
+        int64_t z = scale_acc(acc) + bias;
+        return (relu && z < 0) ? 0 : static_cast<int32_t>(z);
+    }
+
+    //  : coords = {x1, y1, x2, y2, x3, y3}  fixed-point, out = {m, b}
+    void infer(const int32_t* coords, int32_t* out) const {
+        std::vector<int32_t> a(max_width()), z(max_width());
+        infer(coords, out, a.data(), z.data());
+    }
+
+    //  : count   , coords - count*6 , out - count*2.
+    //      (a[i * count + s]),    
+    //      ,        .
+    //      ,   infer(),   .
+    void infer_batch(const int32_t* coords, size_t count, int32_t* out) const {
+        size_t width = max_width();
+        std::vector<int32_t> a(width * count), z(width * count);
+        std::vector<int64_t> acc(count);
+        int32_t in[INPUT_SIZE];
+        for (size_t s = 0; s < count; ++s) {
+            normalize_inputs(coords + s * INPUT_SIZE, in);
+            for (size_t i = 0; i < INPUT_SIZE; ++i) a[i * count + s] = in[i];
+        }
+        for (size_t l = 0; l < layers.size(); ++l) {
+            const QuantizedLayer& layer = layers[l];
+            bool relu = (l + 1 != layers.size());
+            for (uint32_t j = 0; j < layer.outputs; ++j) {
+                std::fill(acc.begin(), acc.end(), 0);
+                for (uint32_t i = 0; i < layer.inputs; ++i) {
+                    int64_t w = layer.weights[i * layer.outputs + j];
+                    const int32_t* ai = a.data() + i * count;
+                    for (size_t s = 0; s < count; ++s) acc[s] += ai[s] * w;
+                }
+                int32_t* zj = z.data() + j * count;
+                for (size_t s = 0; s < count; ++s) zj[s] = activate(acc[s], layer.bias[j], relu);
+            }
+            a.swap(z);
+        }
+        for (size_t s = 0; s < count; ++s) {
+            int32_t last[OUTPUT_SIZE] = {a[s], a[count + s]};
+            denormalize_outputs(last, out + s * OUTPUT_SIZE);
+        }
+    }
+
+    //   :  a  z     
+    void infer(const int32_t* coords, int32_t* out, int32_t* a, int32_t* z) const {
+        normalize_inputs(coords, a);
+
+        for (size_t l = 0; l < layers.size(); ++l) {
+            bool last = (l + 1 == layers.size());
+            run_layer(layers[l], a, z, !last);
+            std::copy(z, z + layers[l].outputs, a);
+        }
+        denormalize_outputs(a, out);
+    }
+};
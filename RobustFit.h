@@ -0,0 +1,321 @@
+#pragma once
+#include <vector>
+#include <utility>
+#include <tuple>
+#include <algorithm>
+#include <stdexcept>
+#include <cmath>
+#include <cstdint>
+#include <cstddef>
+
+#if defined(__AVX512F__)
+#include <immintrin.h>
+#define ROBUST_FIT_AVX512 1
+#elif defined(__AVX2__)
+#include <immintrin.h>
+#define ROBUST_FIT_AVX2 1
+#endif
+
+#include "LineStats.h"
+#include "ThreadPool.h"
+
+//    . Trainer   ,     
+//    ;    :
+//
+// - RANSAC:      (),    
+//       (),      .
+//        x  y,     ,
+//      ,         .
+// - Huber IRLS:   , :     k*s  
+//   k*s/|r|,  s -      (MAD).   - 
+//    LineStats   ,   merge.
+//
+//    ( x ,  y ).     
+//  .     : -mavx2  -march=native.
+
+struct RobustOptions {
+    size_t hypotheses = 256;    //   RANSAC
+    double threshold = 0.0;     //  ; 0 -   
+    double huber_k = 1.345;     //      (95% )
+    int max_iterations = 50;    //  IRLS
+    double tolerance = 1e-10;   //     
+    uint64_t seed = 1;
+};
+
+struct RobustResult {
+    double m = 0.0;
+    double b = 0.0;
+    size_t inliers = 0;   //     (:   k*s)
+    double scale = 0.0;   //  RANSAC    s  
+    int iterations = 0;
+    bool valid = false;   // false -     x 
+};
+
+class RobustRegressor {
+private:
+    static constexpr size_t BLOCK = 8192;          //     
+    static constexpr size_t HYPOTHESIS_CHUNK = 16; //    
+    static constexpr size_t STATS_GRAIN = 65536;   //      
+    static constexpr size_t SCALE_SAMPLE = 1024;   //     RANSAC
+    static constexpr size_t MAD_SAMPLE = 65536;    //    
+
+    std::vector<double> xs;
+    std::vector<double> ys;
+    std::vector<double> abs_residuals; //    ( )
+    ThreadPool* pool;
+
+    //    [0, n)  |y - (m*x + b)| <= t
+    static size_t count_inliers(const double* x, const double* y, size_t n, double m, double b, double t) {
+        size_t i = 0, count = 0;
+#if ROBUST_FIT_AVX512
+        const __m512d vm = _mm512_set1_pd(m), vb = _mm512_set1_pd(b), vt = _mm512_set1_pd(t);
+        for (; i + 8 <= n; i += 8) {
+            __m512d r = _mm512_sub_pd(_mm512_loadu_pd(y + i), _mm512_fmadd_pd(vm, _mm512_loadu_pd(x + i), vb));
+            __m512d a = _mm512_abs_pd(r);
+            count += static_cast<size_t>(__builtin_popcount(_mm512_cmp_pd_mask(a, vt, _CMP_LE_OQ)));
+        }
+#elif ROBUST_FIT_AVX2
+        const __m256d vm = _mm256_set1_pd(m), vb = _mm256_set1_pd(b), vt = _mm256_set1_pd(t);
+        const __m256d sign = _mm256_set1_pd(-0.0);
+        for (; i + 4 <= n; i += 4) {
+            __m256d r = _mm256_sub_pd(_mm256_loadu_pd(y + i),
+                                      _mm256_add_pd(_mm256_mul_pd(vm, _mm256_loadu_pd(x + i)), vb));
+            __m256d a = _mm256_andnot_pd(sign, r);
+            count += static_cast<size_t>(__builtin_popcount(_mm256_movemask_pd(_mm256_cmp_pd(a, vt, _CMP_LE_OQ))));
+        }
+#endif
+        for (; i < n; ++i) {
+            if (std::abs(y[i] - (m * x[i] + b)) <= t) ++count;
+        }
+        return count;
+    }
+
+    // fn(chunk, begin, end)   [0, n);   
+    template<typename Fn>
+    size_t for_chunks(size_t n, size_t grain, Fn&& fn) const {
+        size_t chunks = (n + grain - 1) / grain;
+        auto task = [&](size_t c) { fn(c, c * grain, std::min(n, (c + 1) * grain)); };
+        if (pool && chunks > 1) {
+            pool->run(chunks, task);
+        } else {
+            for (size_t c = 0; c < chunks; ++c) task(c);
+        }
+        return chunks;
+    }
+
+    //   ,   weight(r) > 0,  r -    (m, b).
+    //          
+    // (    ,    LineStats::add),  
+    //   LineStats.       ,
+    //        .
+    template<typename Weight>
+    LineStats weighted_stats(double m, double b, Weight weight) const {
+        size_t n = xs.size();
+        std::vector<LineStats> parts((n + STATS_GRAIN - 1) / STATS_GRAIN);
+        for_chunks(n, STATS_GRAIN, [&](size_t c, size_t begin, size_t end) {
+            double x0 = xs[begin], y0 = ys[begin];
+            double sw = 0.0, sx = 0.0, sy = 0.0, sxx = 0.0, sxy = 0.0, syy = 0.0;
+            uint64_t count = 0;
+            for (size_t i = begin; i < end; ++i) {
+                double w = weight(ys[i] - (m * xs[i] + b));
+                if (!(w > 0.0)) continue;
+                double dx = xs[i] - x0, dy = ys[i] - y0;
+                ++count;
+                sw += w;
+                sx += w * dx;
+                sy += w * dy;
+                sxx += w * dx * dx;
+                sxy += w * dx * dy;
+                syy += w * dy * dy;
+            }
+            LineStats& s = parts[c];
+            if (count == 0) return;
+            s.count = count;
+            s.weight = sw;
+            s.mean_x = x0 + sx / sw;
+            s.mean_y = y0 + sy / sw;
+            s.sxx = std::max(0.0, sxx - sx * sx / sw);
+            s.sxy = sxy - sx * sy / sw;
+            s.syy = std::max(0.0, syy - sy * sy / sw);
+        });
+        LineStats total;
+        for (const auto& s : parts) total.merge(s);
+        return total;
+    }
+
+    size_t count_all(double m, double b, double t) const {
+        size_t n = xs.size();
+        std::vector<size_t> counts((n + STATS_GRAIN - 1) / STATS_GRAIN);
+        for_chunks(n, STATS_GRAIN, [&](size_t c, size_t begin, size_t end) {
+            counts[c] = count_inliers(xs.data() + begin, ys.data() + begin, end - begin, m, b, t);
+        });
+        size_t total = 0;
+        for (size_t c : counts) total += c;
+        return total;
+    }
+
+    static uint64_t next_random(uint64_t& state) {
+        uint64_t z = (state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    //        [0, n)   stride; false - 
+    //     x
+    bool sample_line(uint64_t& state, size_t n, size_t stride, double& m, double& b) const {
+        for (int attempt = 0; attempt < 8; ++attempt) {
+            size_t i = static_cast<size_t>(next_random(state) % n) * stride;
+            size_t j = static_cast<size_t>(next_random(state) % n) * stride;
+            double dx = xs[j] - xs[i];
+            if (i == j || std::abs(dx) < 1e-12) continue;
+            m = (ys[j] - ys[i]) / dx;
+            b = ys[i] - m * xs[i];
+            return true;
+        }
+        return false;
+    }
+
+    //    : LMedS    (  
+    //   )     , s = 1.4826*(1 + 5/(n-2))*sqrt(med).
+    //  - 2.5*s.    ,     .
+    double estimate_threshold(const RobustOptions& options) const {
+        size_t stride = std::max<size_t>(1, xs.size() / SCALE_SAMPLE);
+        size_t n = xs.size() / stride;
+        std::vector<double> squares(n);
+        uint64_t state = options.seed ^ 0x5CA1E;
+        double best = INFINITY;
+        for (size_t h = 0; h < options.hypotheses; ++h) {
+            double m, b;
+            if (!sample_line(state, n, stride, m, b)) continue;
+            for (size_t i = 0; i < n; ++i) {
+                double r = ys[i * stride] - (m * xs[i * stride] + b);
+                squares[i] = r * r;
+            }
+            std::nth_element(squares.begin(), squares.begin() + n / 2, squares.end());
+            best = std::min(best, squares[n / 2]);
+        }
+        if (!std::isfinite(best)) return 0.0;
+        double sigma = 1.4826 * (1.0 + 5.0 / static_cast<double>(std::max<size_t>(n, 3) - 2)) * std::sqrt(best);
+        //  :     
+        double floor = 1e-9 * (1.0 + std::abs(ys[0]));
+        return std::max(2.5 * sigma, floor);
+    }
+
+public:
+    // pool -     ;    
+    explicit RobustRegressor(ThreadPool* pool = nullptr) : pool(pool) {}
+
+    void reserve(size_t n) {
+        xs.reserve(n);
+        ys.reserve(n);
+    }
+
+    void add(double x, double y) {
+        xs.push_back(x);
+        ys.push_back(y);
+    }
+
+    void clear() {
+        xs.clear();
+        ys.clear();
+    }
+
+    size_t size() const { return xs.size(); }
+
+    //       -  
+    RobustResult fit_ols() const {
+        RobustResult result;
+        LineStats s = weighted_stats(0.0, 0.0, [](double) { return 1.0; });
+        result.valid = s.solvable();
+        std::tie(result.m, result.b) = s.solve();
+        result.inliers = xs.size();
+        return result;
+    }
+
+    RobustResult fit_ransac(const RobustOptions& options = RobustOptions()) const {
+        RobustResult result;
+        size_t n = xs.size();
+        if (n < 2 || options.hypotheses == 0) return result;
+
+        double threshold = options.threshold > 0.0 ? options.threshold : estimate_threshold(options);
+        if (threshold <= 0.0) return result;
+
+        //     ,      
+        std::vector<std::pair<double, double>> lines;
+        lines.reserve(options.hypotheses);
+        uint64_t state = options.seed;
+        for (size_t h = 0; h < options.hypotheses; ++h) {
+            double m, b;
+            if (sample_line(state, n, 1, m, b)) lines.push_back({m, b});
+        }
+        if (lines.empty()) return result;
+
+        std::vector<size_t> counts(lines.size(), 0);
+        for_chunks(lines.size(), HYPOTHESIS_CHUNK, [&](size_t, size_t first, size_t last) {
+            for (size_t begin = 0; begin < n; begin += BLOCK) {
+                size_t len = std::min(BLOCK, n - begin);
+                for (size_t h = first; h < last; ++h) {
+                    counts[h] += count_inliers(xs.data() + begin, ys.data() + begin, len,
+                                               lines[h].first, lines[h].second, threshold);
+                }
+            }
+        });
+        size_t best = static_cast<size_t>(std::max_element(counts.begin(), counts.end()) - counts.begin());
+
+        // :     ,      
+        double m = lines[best].first, b = lines[best].second;
+        for (int pass = 0; pass < 2; ++pass) {
+            LineStats s = weighted_stats(m, b, [threshold](double r) { return std::abs(r) <= threshold ? 1.0 : 0.0; });
+            if (!s.solvable()) break;
+            std::tie(m, b) = s.solve();
+            result.iterations = pass + 1;
+        }
+        result.m = m;
+        result.b = b;
+        result.inliers = count_all(m, b, threshold);
+        result.scale = threshold;
+        result.valid = result.inliers >= 2;
+        return result;
+    }
+
+    // start -   (,  RANSAC);   - 
+    RobustResult fit_huber(const RobustOptions& options = RobustOptions(), const RobustResult* start = nullptr) {
+        RobustResult result = start && start->valid ? *start : fit_ols();
+        result.iterations = 0;
+        if (!result.valid) return result;
+
+        //       :  
+        //  64K  ,   nth_element     
+        // ,    
+        size_t stride = std::max<size_t>(1, xs.size() / MAD_SAMPLE);
+        size_t n = xs.size() / stride;
+        abs_residuals.resize(n);
+        double m = result.m, b = result.b, scale = 0.0;
+        for (int it = 0; it < options.max_iterations; ++it) {
+            for (size_t i = 0; i < n; ++i) abs_residuals[i] = std::abs(ys[i * stride] - (m * xs[i * stride] + b));
+            auto mid = abs_residuals.begin() + n / 2;
+            std::nth_element(abs_residuals.begin(), mid, abs_residuals.end());
+            scale = 1.4826 * *mid;
+            result.iterations = it + 1;
+            if (scale <= 0.0) break; //      
+
+            double c = options.huber_k * scale;
+            LineStats s = weighted_stats(m, b, [c](double r) {
+                double a = std::abs(r);
+                return a <= c ? 1.0 : c / a;
+            });
+            if (!s.solvable()) break;
+            auto [new_m, new_b] = s.solve();
+            double change = std::abs(new_m - m) + std::abs(new_b - b);
+            m = new_m;
+            b = new_b;
+            if (change <= options.tolerance * (1.0 + std::abs(m) + std::abs(b))) break;
+        }
+        result.m = m;
+        result.b = b;
+        result.scale = scale;
+        result.inliers = count_all(m, b, std::max(options.huber_k * scale, 1e-12));
+        return result;
+    }
+};
@@ -0,0 +1,413 @@
+#pragma once
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <future>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <cstdint>
+#include <cstddef>
+
+#include "FitMetrics.h"
+
+//   :      (),  -  .
+//
+//      .       
+//  ,    ,      .
+//       lock-free  (Vyukov MPMC). 
+//          ,  
+//      .     :
+// ,   ,   .
+
+using SeriesId = uint64_t;
+
+struct SeriesUpdate {
+    SeriesId id;
+    double x;
+    double y;
+};
+
+struct SeriesCoeffs {
+    double m = 0.0;
+    double b = 0.0;
+    uint64_t count = 0;
+    bool valid = false; // false -       
+    double rmse = 0.0;  //    (FitMetrics.h),  
+    double r2 = 0.0;
+    double mean_abs_residual = 0.0;
+};
+
+//        (D. Vyukov).
+//  -  ;   try_push  false.
+template<typename T>
+class BoundedMpmcQueue {
+private:
+    struct Cell {
+        std::atomic<size_t> sequence;
+        T value;
+    };
+
+    std::unique_ptr<Cell[]> cells;
+    size_t mask;
+    alignas(64) std::atomic<size_t> enqueue_pos{0};
+    alignas(64) std::atomic<size_t> dequeue_pos{0};
+
+public:
+    explicit BoundedMpmcQueue(size_t capacity) {
+        if (capacity < 2 || (capacity & (capacity - 1)) != 0) {
+            throw std::runtime_error("Queue capacity must be a power of two");
+        }
+        cells.reset(new Cell[capacity]);
+        mask = capacity - 1;
+        for (size_t i = 0; i < capacity; ++i) cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    bool try_push(T& value) {
+        size_t pos = enqueue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos);
+            if (diff == 0) {
+                if (enqueue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = std::move(value);
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = enqueue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    bool try_pop(T& value) {
+        size_t pos = dequeue_pos.load(std::memory_order_relaxed);
+        while (true) {
+            Cell& cell = cells[pos & mask];
+            size_t seq = cell.sequence.load(std::memory_order_acquire);
+            intptr_t diff = static_cast<intptr_t>(seq) - static_cast<intptr_t>(pos + 1);
+            if (diff == 0) {
+                if (dequeue_pos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    value = std::move(cell.value);
+                    cell.sequence.store(pos + mask + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false;
+            } else {
+                pos = dequeue_pos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+};
+
+//   :     ,   
+//   ,       .
+class SeriesTable {
+private:
+    std::vector<SeriesId> keys;
+    std::vector<uint8_t> used;
+    std::vector<LineFit> stats;
+    size_t count = 0;
+    size_t mask = 0;
+
+    void grow() {
+        SeriesTable bigger(keys.size() * 2);
+        for (size_t i = 0; i < keys.size(); ++i) {
+            if (used[i]) bigger.insert(keys[i], hash_slot(keys[i])) = stats[i];
+        }
+        *this = std::move(bigger);
+    }
+
+    LineFit& insert(SeriesId id, uint64_t hash) {
+        size_t i = hash & mask;
+        while (used[i]) {
+            if (keys[i] == id) return stats[i];
+            i = (i + 1) & mask;
+        }
+        used[i] = 1;
+        keys[i] = id;
+        ++count;
+        return stats[i];
+    }
+
+public:
+    explicit SeriesTable(size_t capacity = 1024) {
+        size_t size = 16;
+        while (size < capacity) size *= 2;
+        keys.assign(size, 0);
+        used.assign(size, 0);
+        stats.assign(size, LineFit());
+        mask = size - 1;
+    }
+
+    //  splitmix64:     
+    //        
+    static uint64_t hash_slot(SeriesId id) {
+        uint64_t z = id + 0x9E3779B97F4A7C15ULL;
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    size_t size() const { return count; }
+
+    LineFit& upsert(SeriesId id) {
+        if ((count + 1) * 10 > keys.size() * 7) grow();
+        return insert(id, hash_slot(id));
+    }
+
+    const LineFit* find(SeriesId id) const {
+        size_t i = hash_slot(id) & mask;
+        while (used[i]) {
+            if (keys[i] == id) return &stats[i];
+            i = (i + 1) & mask;
+        }
+        return nullptr;
+    }
+};
+
+class SeriesEngine {
+public:
+    struct Options {
+        size_t shards = std::max(1u, std::thread::hardware_concurrency());
+        size_t queue_capacity = 1024;      //   ,  
+        size_t expected_series = 1 << 17;  //    (  )
+    };
+
+    struct Stats {
+        uint64_t series = 0;
+        uint64_t updates = 0;
+    };
+
+private:
+    //    :  ,    ,
+    //  promise.  ,     ,
+    //   ,     set_value().
+    struct QueryBatch {
+        const SeriesId* ids = nullptr;
+        SeriesCoeffs* out = nullptr;
+        std::atomic<size_t> remaining{0};
+        std::promise<void> done;
+    };
+
+    struct Command {
+        enum class Kind { Update, Query, Barrier, Stop };
+        Kind kind = Kind::Update;
+        std::vector<SeriesUpdate> updates;  // Update
+        std::vector<uint32_t> indices;      // Query:   id  
+        std::shared_ptr<QueryBatch> query;  // Query / Barrier
+    };
+
+    struct Shard {
+        BoundedMpmcQueue<Command> queue;
+        SeriesTable table;
+        std::thread worker;
+        std::atomic<uint64_t> series{0};
+        std::atomic<uint64_t> updates{0};
+
+        //      
+        std::atomic<bool> sleeping{false};
+        std::mutex wake_mutex;
+        std::condition_variable wake_cv;
+
+        Shard(size_t capacity, size_t table_size) : queue(capacity), table(table_size) {}
+    };
+
+    std::vector<std::unique_ptr<Shard>> shards;
+
+    size_t shard_of(SeriesId id) const {
+        //    -  ,  -     
+        return static_cast<size_t>((SeriesTable::hash_slot(id) >> 32) % shards.size());
+    }
+
+    void push(Shard& shard, Command& cmd) {
+        unsigned spins = 0;
+        while (!shard.queue.try_push(cmd)) {
+            //   -   ; ,   
+            if (++spins < 64) continue;
+            std::this_thread::yield();
+        }
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (shard.sleeping.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(shard.wake_mutex);
+            shard.wake_cv.notify_one();
+        }
+    }
+
+    static void complete(const std::shared_ptr<QueryBatch>& query) {
+        if (query->remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) query->done.set_value();
+    }
+
+    static void run_shard(Shard& shard) {
+        Command cmd;
+        unsigned idle = 0;
+        while (true) {
+            if (!shard.queue.try_pop(cmd)) {
+                if (++idle < 256) continue;
+                //  : .      ,
+                //     ,    .
+                shard.sleeping.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (!shard.queue.try_pop(cmd)) {
+                    std::unique_lock<std::mutex> lock(shard.wake_mutex);
+                    shard.wake_cv.wait_for(lock, std::chrono::milliseconds(1));
+                    shard.sleeping.store(false, std::memory_order_relaxed);
+                    continue;
+                }
+                shard.sleeping.store(false, std::memory_order_relaxed);
+            }
+            idle = 0;
+
+            switch (cmd.kind) {
+            case Command::Kind::Update: {
+                size_t before = shard.table.size();
+                for (const auto& u : cmd.updates) shard.table.upsert(u.id).add(u.x, u.y);
+                shard.updates.fetch_add(cmd.updates.size(), std::memory_order_relaxed);
+                shard.series.fetch_add(shard.table.size() - before, std::memory_order_relaxed);
+                break;
+            }
+            case Command::Kind::Query:
+                for (uint32_t i : cmd.indices) {
+                    SeriesCoeffs& out = cmd.query->out[i];
+                    const LineFit* fit = shard.table.find(cmd.query->ids[i]);
+                    if (fit) {
+                        auto [m, b] = fit->stats.solve();
+                        FitMetrics metrics;
+                        fit->fill(metrics);
+                        out.m = m;
+                        out.b = b;
+                        out.count = metrics.count;
+                        out.valid = metrics.valid;
+                        out.rmse = metrics.rmse;
+                        out.r2 = metrics.r2;
+                        out.mean_abs_residual = metrics.mean_abs_residual;
+                    } else {
+                        out = SeriesCoeffs();
+                    }
+                }
+                complete(cmd.query);
+                break;
+            case Command::Kind::Barrier:
+                complete(cmd.query);
+                break;
+            case Command::Kind::Stop:
+                return;
+            }
+        }
+    }
+
+public:
+    explicit SeriesEngine(const Options& options) {
+        if (options.shards == 0) throw std::runtime_error("SeriesEngine needs at least one shard");
+        size_t table_size = options.expected_series / options.shards + 1;
+        for (size_t i = 0; i < options.shards; ++i) {
+            shards.push_back(std::make_unique<Shard>(options.queue_capacity, table_size));
+        }
+        for (auto& shard : shards) {
+            Shard* s = shard.get();
+            s->worker = std::thread([s] { run_shard(*s); });
+        }
+    }
+
+    SeriesEngine() : SeriesEngine(Options()) {}
+
+    ~SeriesEngine() {
+        for (auto& shard : shards) {
+            Command stop;
+            stop.kind = Command::Kind::Stop;
+            push(*shard, stop);
+        }
+        for (auto& shard : shards) shard->worker.join();
+    }
+
+    SeriesEngine(const SeriesEngine&) = delete;
+    SeriesEngine& operator=(const SeriesEngine&) = delete;
+
+    size_t shard_count() const { return shards.size(); }
+
+    //  :   ,     .
+    //     -    flush()  query_batch().
+    void update_batch(const SeriesUpdate* updates, size_t count) {
+        std::vector<Command> parts(shards.size());
+        size_t per_shard = count / shards.size() + 1;
+        for (auto& part : parts) part.updates.reserve(per_shard + per_shard / 4);
+        for (size_t i = 0; i < count; ++i) parts[shard_of(updates[i].id)].updates.push_back(updates[i]);
+        for (size_t s = 0; s < shards.size(); ++s) {
+            if (!parts[s].updates.empty()) push(*shards[s], parts[s]);
+        }
+    }
+
+    void update_batch(const std::vector<SeriesUpdate>& updates) { update_batch(updates.data(), updates.size()); }
+
+    void update(SeriesId id, double x, double y) {
+        SeriesUpdate u{id, x, y};
+        update_batch(&u, 1);
+    }
+
+    //   count  ; out[i]  ids[i].
+    //   ,       .
+    void query_batch(const SeriesId* ids, size_t count, SeriesCoeffs* out) {
+        if (count == 0) return;
+        std::vector<Command> parts(shards.size());
+        for (size_t i = 0; i < count; ++i) parts[shard_of(ids[i])].indices.push_back(static_cast<uint32_t>(i));
+
+        auto query = std::make_shared<QueryBatch>();
+        query->ids = ids;
+        query->out = out;
+        size_t involved = 0;
+        for (const auto& part : parts) involved += part.indices.empty() ? 0 : 1;
+        query->remaining.store(involved, std::memory_order_relaxed);
+        auto done = query->done.get_future();
+
+        for (size_t s = 0; s < shards.size(); ++s) {
+            if (parts[s].indices.empty()) continue;
+            parts[s].kind = Command::Kind::Query;
+            parts[s].query = query;
+            push(*shards[s], parts[s]);
+        }
+        done.wait();
+    }
+
+    std::vector<SeriesCoeffs> query_batch(const std::vector<SeriesId>& ids) {
+        std::vector<SeriesCoeffs> out(ids.size());
+        query_batch(ids.data(), ids.size(), out.data());
+        return out;
+    }
+
+    SeriesCoeffs query(SeriesId id) {
+        SeriesCoeffs out;
+        query_batch(&id, 1, &out);
+        return out;
+    }
+
+    // ,    ,     
+    void flush() {
+        auto barrier = std::make_shared<QueryBatch>();
+        barrier->remaining.store(shards.size(), std::memory_order_relaxed);
+        auto done = barrier->done.get_future();
+        for (auto& shard : shards) {
+            Command cmd;
+            cmd.kind = Command::Kind::Barrier;
+            cmd.query = barrier;
+            push(*shard, cmd);
+        }
+        done.wait();
+    }
+
+    //         
+    Stats get_stats() const {
+        Stats stats;
+        for (const auto& shard : shards) {
+            stats.series += shard->series.load(std::memory_order_relaxed);
+            stats.updates += shard->updates.load(std::memory_order_relaxed);
+        }
+        return stats;
+    }
+};
@@ -0,0 +1,116 @@
+#pragma once
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+
+#include "QuantizedMlp.h"
+
+// -  (BSR).    -  i,     
+// BLOCK  ,     : row_start[i]..row_start[i+1] -
+//   i, block_col[k] -    , values[k*BLOCK..] -  
+// (    ).
+struct SparseLayer {
+    uint32_t inputs = 0;
+    uint32_t outputs = 0;
+    std::vector<uint32_t> row_start;
+    std::vector<uint32_t> block_col;
+    std::vector<int32_t> values;
+    const int32_t* bias = nullptr;
+};
+
+//       (generate_weights --prune). ,
+//      ,  :   
+//   ,      ( ReLU 
+//  )  .   64-   
+//    ,  ,   ReLU  
+// QuantizedMlp,       .
+//
+//     QuantizedMlp (, ,  ),
+//      .
+class SparseMlp {
+public:
+    static constexpr size_t BLOCK = 4; //   :   w*.mem  4 
+
+private:
+    const QuantizedMlp* dense;
+    std::vector<SparseLayer> layers;
+    size_t width = 0; //   ,    BLOCK
+
+    void run_layer(const SparseLayer& layer, const int32_t* in, int32_t* out, int64_t* acc, bool relu) const {
+        size_t padded = (layer.outputs + BLOCK - 1) / BLOCK * BLOCK;
+        std::fill(acc, acc + padded, 0);
+        for (uint32_t i = 0; i < layer.inputs; ++i) {
+            int64_t v = in[i];
+            if (v == 0) continue;
+            for (uint32_t k = layer.row_start[i]; k < layer.row_start[i + 1]; ++k) {
+                int64_t* a = acc + static_cast<size_t>(layer.block_col[k]) * BLOCK;
+                const int32_t* w = layer.values.data() + static_cast<size_t>(k) * BLOCK;
+                for (size_t t = 0; t < BLOCK; ++t) a[t] += v * w[t];
+            }
+        }
+        for (uint32_t j = 0; j < layer.outputs; ++j) out[j] = dense->activate(acc[j], layer.bias[j], relu);
+    }
+
+public:
+    explicit SparseMlp(const QuantizedMlp& source) : dense(&source) {
+        width = QuantizedMlp::INPUT_SIZE;
+        for (const auto& src : source.get_layers()) {
+            SparseLayer layer;
+            layer.inputs = src.inputs;
+            layer.outputs = src.outputs;
+            layer.bias = src.bias;
+            size_t blocks = (src.outputs + BLOCK - 1) / BLOCK;
+            layer.row_start.push_back(0);
+            for (uint32_t i = 0; i < src.inputs; ++i) {
+                const int32_t* row = src.weights + static_cast<size_t>(i) * src.outputs;
+                for (size_t c = 0; c < blocks; ++c) {
+                    size_t begin = c * BLOCK, end = std::min<size_t>(begin + BLOCK, src.outputs);
+                    if (std::all_of(row + begin, row + end, [](int32_t w) { return w == 0; })) continue;
+                    layer.block_col.push_back(static_cast<uint32_t>(c));
+                    for (size_t j = begin; j < begin + BLOCK; ++j) layer.values.push_back(j < end ? row[j] : 0);
+                }
+                layer.row_start.push_back(static_cast<uint32_t>(layer.block_col.size()));
+            }
+            width = std::max(width, blocks * BLOCK);
+            layers.push_back(std::move(layer));
+        }
+    }
+
+    const std::vector<SparseLayer>& get_layers() const { return layers; }
+
+    //   a, z  acc   infer  
+    size_t buffer_size() const { return width; }
+
+    //   :        (   )
+    size_t dense_macs() const {
+        size_t macs = 0;
+        for (const auto& layer : layers) macs += static_cast<size_t>(layer.inputs) * layer.outputs;
+        return macs;
+    }
+
+    size_t macs() const {
+        size_t macs = 0;
+        for (const auto& layer : layers) {
+            for (uint32_t c : layer.block_col) macs += std::min<size_t>(BLOCK, layer.outputs - c * BLOCK);
+        }
+        return macs;
+    }
+
+    void infer(const int32_t* coords, int32_t* out) const {
+        std::vector<int32_t> a(width), z(width);
+        std::vector<int64_t> acc(width);
+        infer(coords, out, a.data(), z.data(), acc.data());
+    }
+
+    //   :    buffer_size()
+    void infer(const int32_t* coords, int32_t* out, int32_t* a, int32_t* z, int64_t* acc) const {
+        dense->normalize_inputs(coords, a);
+        for (size_t l = 0; l < layers.size(); ++l) {
+            bool last = (l + 1 == layers.size());
+            run_layer(layers[l], a, z, acc, !last);
+            std::copy(z, z + layers[l].outputs, a);
+        }
+        dense->denormalize_outputs(a, out);
+    }
+};
@@ -0,0 +1,145 @@
+#pragma once
+#include <array>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <cstddef>
+#include <stdexcept>
+
+#include "QuantizedMlp.h"
+
+//    ,    : StaticMlp<6, 32, 16, 2> -
+//   ,   QuantizedMlp (  neural_inference),    -
+//  ,        
+// ,      .     
+// BLOCK :     ,   [][]
+//  .       ,  
+// QuantizedMlp::infer,   .
+//
+//  -     W1, B1, W2, B2, ... ( storage  QuantizedMlp).
+//  - ,     constexpr  ,   :
+//    "weights_tool header" (network_weights.h).    SCALE
+// -   ,     SCALE 
+// .         (STATIC_MLP_INLINE):
+//          .   
+//     .
+#if defined(__GNUC__)
+#define STATIC_MLP_INLINE __attribute__((always_inline))
+#else
+#define STATIC_MLP_INLINE
+#endif
+
+template<size_t... Sizes>
+class StaticMlp {
+    static_assert(sizeof...(Sizes) >= 2, "Network needs at least one layer");
+
+public:
+    using ScaleMode = QuantizedMlp::ScaleMode;
+    using Constants = QuantizedMlp::FixedPointConstants;
+
+    static constexpr size_t LAYERS = sizeof...(Sizes) - 1;
+    static constexpr std::array<size_t, LAYERS + 1> SIZES{Sizes...};
+    static constexpr size_t INPUT_SIZE = SIZES.front();
+    static constexpr size_t OUTPUT_SIZE = SIZES.back();
+    static constexpr size_t BLOCK = 8; //   : 8 x int64 =   AVX-512
+
+    static_assert(INPUT_SIZE == QuantizedMlp::INPUT_SIZE, "Input layer must have 6 inputs");
+    static_assert(OUTPUT_SIZE == QuantizedMlp::OUTPUT_SIZE, "Output layer must have 2 outputs");
+
+    static constexpr size_t weights_offset(size_t layer) {
+        size_t offset = 0;
+        for (size_t l = 0; l < layer; ++l) offset += SIZES[l] * SIZES[l + 1] + SIZES[l + 1];
+        return offset;
+    }
+    static constexpr size_t bias_offset(size_t layer) { return weights_offset(layer) + SIZES[layer] * SIZES[layer + 1]; }
+
+    static constexpr size_t max_width() {
+        size_t width = 0;
+        for (size_t s : SIZES) width = width > s ? width : s;
+        return width;
+    }
+
+    static constexpr size_t PARAM_COUNT = weights_offset(LAYERS);
+    static constexpr size_t MAX_WIDTH = max_width();
+
+    using Params = std::array<int32_t, PARAM_COUNT>;
+
+    Constants constants;
+    ScaleMode scale_mode;
+    Params params;
+
+    //      ;      
+    static StaticMlp from(const QuantizedMlp& source) {
+        const auto& layers = source.get_layers();
+        if (layers.size() != LAYERS) throw std::runtime_error("Network depth does not match StaticMlp");
+        StaticMlp net{source.fixed_point_constants(), source.get_scale_mode(), {}};
+        for (size_t l = 0; l < LAYERS; ++l) {
+            if (layers[l].inputs != SIZES[l] || layers[l].outputs != SIZES[l + 1]) {
+                throw std::runtime_error("Layer " + std::to_string(l + 1) + " shape does not match StaticMlp");
+            }
+            std::copy(layers[l].weights, layers[l].weights + SIZES[l] * SIZES[l + 1], net.params.begin() + weights_offset(l));
+            std::copy(layers[l].bias, layers[l].bias + SIZES[l + 1], net.params.begin() + bias_offset(l));
+        }
+        return net;
+    }
+
+    //  : coords = {x1, y1, x2, y2, x3, y3}  fixed-point, out = {m, b}
+    STATIC_MLP_INLINE void infer(const int32_t* coords, int32_t* out) const {
+        int32_t a[MAX_WIDTH], z[MAX_WIDTH];
+        a[0] = normalize(coords[0], constants.x_min_fp, constants.x_half_range);
+        a[1] = normalize(coords[1], constants.y_min_fp, constants.y_half_range);
+        a[2] = normalize(coords[2], constants.x_min_fp, constants.x_half_range);
+        a[3] = normalize(coords[3], constants.y_min_fp, constants.y_half_range);
+        a[4] = normalize(coords[4], constants.x_min_fp, constants.x_half_range);
+        a[5] = normalize(coords[5], constants.y_min_fp, constants.y_half_range);
+        const int32_t* last = forward<0>(a, z);
+        out[0] = denormalize(last[0]);
+        out[1] = denormalize(last[1]);
+    }
+
+private:
+    //  -  QuantizedMlp: normalize, denormalize, activate
+    STATIC_MLP_INLINE int32_t normalize(int32_t val, int64_t min_fp, int64_t half_range) const {
+        return static_cast<int32_t>((static_cast<int64_t>(val) - min_fp) / half_range - constants.scale);
+    }
+
+    STATIC_MLP_INLINE int32_t denormalize(int32_t val) const {
+        return static_cast<int32_t>((static_cast<int64_t>(val) + constants.scale) * constants.mb_half_range + constants.mb_min_fp);
+    }
+
+    STATIC_MLP_INLINE int32_t activate(int64_t acc, int32_t bias, bool relu) const {
+        int64_t scaled = scale_mode == ScaleMode::Divide
+            ? acc / constants.scale
+            : static_cast<int64_t>((static_cast<__int128>(acc) * constants.inv_scale) >> 32);
+        int64_t z = scaled + bias;
+        return (relu && z < 0) ? 0 : static_cast<int32_t>(z);
+    }
+
+    //  J..J+BLOCK-1  L (     )
+    template<size_t L, size_t J>
+    STATIC_MLP_INLINE void run_block(const int32_t* in, int32_t* out) const {
+        constexpr size_t IN = SIZES[L], OUT = SIZES[L + 1];
+        constexpr size_t WIDTH = OUT - J < BLOCK ? OUT - J : BLOCK;
+        constexpr bool RELU = L + 1 < LAYERS;
+        const int32_t* w = params.data() + weights_offset(L) + J;
+        const int32_t* bias = params.data() + bias_offset(L) + J;
+
+        int64_t acc[WIDTH] = {};
+        #pragma GCC unroll 64
+        for (size_t i = 0; i < IN; ++i) {
+            int64_t v = in[i];
+            for (size_t t = 0; t < WIDTH; ++t) acc[t] += v * w[i * OUT + t];
+        }
+        for (size_t t = 0; t < WIDTH; ++t) out[J + t] = activate(acc[t], bias[t], RELU);
+
+        if constexpr (J + BLOCK < OUT) run_block<L, J + BLOCK>(in, out);
+    }
+
+    //  L..LAYERS-1   ;    
+    template<size_t L>
+    STATIC_MLP_INLINE const int32_t* forward(int32_t* a, int32_t* z) const {
+        run_block<L, 0>(a, z);
+        if constexpr (L + 1 < LAYERS) return forward<L + 1>(z, a);
+        else return z;
+    }
+};
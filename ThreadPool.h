@@ -0,0 +1,156 @@
+#pragma once
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <functional>
+#include <exception>
+#include <algorithm>
+
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+//      .      
+//    ,       ,
+//    .     ,   .
+class ThreadPool {
+private:
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable work_cv;
+    std::condition_variable done_cv;
+
+    const std::function<void(size_t)>* job = nullptr;
+    size_t job_count = 0;
+    std::atomic<size_t> next_index{0};
+    size_t busy_workers = 0;
+    uint64_t generation = 0;
+    bool stopping = false;
+    std::exception_ptr error;
+
+    void execute(const std::function<void(size_t)>& fn, size_t count) {
+        size_t i;
+        while ((i = next_index.fetch_add(1, std::memory_order_relaxed)) < count) {
+            try {
+                fn(i);
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (!error) error = std::current_exception();
+            }
+        }
+    }
+
+    void worker_loop() {
+        uint64_t seen = 0;
+        while (true) {
+            const std::function<void(size_t)>* fn;
+            size_t count;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                work_cv.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+                fn = job;
+                count = job_count;
+            }
+            execute(*fn, count);
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                if (--busy_workers == 0) done_cv.notify_one();
+            }
+        }
+    }
+
+public:
+    // threads -       
+    explicit ThreadPool(size_t threads = std::thread::hardware_concurrency()) {
+        threads = std::max<size_t>(1, threads);
+        for (size_t i = 0; i + 1 < threads; ++i) {
+            workers.emplace_back([this] { worker_loop(); });
+        }
+    }
+
+    ~ThreadPool() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        work_cv.notify_all();
+        for (auto& t : workers) t.join();
+    }
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    size_t size() const { return workers.size() + 1; }
+
+    const std::vector<std::thread>& threads() const { return workers; }
+
+    //        :   -
+    //  ,  -   ( ,   ,  ).
+    //       . false -   
+    //    Linux.
+    bool pin_to_cores() {
+#ifdef __linux__
+        cpu_set_t allowed;
+        CPU_ZERO(&allowed);
+        if (sched_getaffinity(0, sizeof(allowed), &allowed) != 0) return false;
+        std::vector<int> cores;
+        for (int c = 0; c < CPU_SETSIZE; ++c) {
+            if (CPU_ISSET(c, &allowed)) cores.push_back(c);
+        }
+        if (cores.empty()) return false;
+        auto pin = [&](pthread_t thread, size_t index) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cores[index % cores.size()], &set);
+            return pthread_setaffinity_np(thread, sizeof(set), &set) == 0;
+        };
+        bool ok = pin(pthread_self(), 0);
+        for (size_t i = 0; i < workers.size(); ++i) ok = pin(workers[i].native_handle(), i + 1) && ok;
+        return ok;
+#else
+        return false;
+#endif
+    }
+
+    //  fn(i)   i  [0, count)  ,   .
+    //      .
+    void run(size_t count, const std::function<void(size_t)>& fn) {
+        if (count == 0) return;
+        if (workers.empty() || count == 1) {
+            for (size_t i = 0; i < count; ++i) fn(i);
+            return;
+        }
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            job = &fn;
+            job_count = count;
+            next_index.store(0, std::memory_order_relaxed);
+            busy_workers = workers.size();
+            error = nullptr;
+            ++generation;
+        }
+        work_cv.notify_all();
+        execute(fn, count);
+
+        std::unique_lock<std::mutex> lock(mutex);
+        done_cv.wait(lock, [&] { return busy_workers == 0; });
+        job = nullptr;
+        if (error) std::rethrow_exception(error);
+    }
+
+    //   [begin, end)    grain : fn(chunk_begin, chunk_end)
+    void parallel_for(size_t begin, size_t end, size_t grain, const std::function<void(size_t, size_t)>& fn) {
+        if (end <= begin) return;
+        grain = std::max<size_t>(1, grain);
+        size_t chunks = (end - begin + grain - 1) / grain;
+        run(chunks, [&](size_t c) {
+            size_t b = begin + c * grain;
+            fn(b, std::min(end, b + grain));
+        });
+    }
+};
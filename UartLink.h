@@ -0,0 +1,400 @@
+#pragma once
+#include <vector>
+#include <deque>
+#include <algorithm>
+#include <string>
+#include <chrono>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+//    top_module (й3)  AXI UARTLite, 8N1:
+//  - 6   32  (x1, y1, x2, y2, x3, y3), 24 ;
+//   - 2   32  (m, b), 8 .
+//   - fixed-point  SCALE,     ,
+//    S_TX_WRITE.        ,
+//       .
+namespace UartProtocol {
+    constexpr size_t QUERY_WORDS = 6;
+    constexpr size_t REPLY_WORDS = 2;
+    constexpr size_t QUERY_BYTES = QUERY_WORDS * 4;
+    constexpr size_t REPLY_BYTES = REPLY_WORDS * 4;
+
+    inline void put_word(uint8_t* dst, int32_t value) {
+        uint32_t u = static_cast<uint32_t>(value);
+        for (int i = 0; i < 4; ++i) dst[i] = static_cast<uint8_t>(u >> (i * 8));
+    }
+
+    inline int32_t get_word(const uint8_t* src) {
+        uint32_t u = 0;
+        for (int i = 0; i < 4; ++i) u |= static_cast<uint32_t>(src[i]) << (i * 8);
+        return static_cast<int32_t>(u);
+    }
+
+    //     ( + 8  + )   
+    inline std::chrono::nanoseconds byte_time(int baud) {
+        return std::chrono::nanoseconds(10LL * 1000000000LL / baud);
+    }
+}
+
+struct UartQuery {
+    int32_t coords[UartProtocol::QUERY_WORDS];
+};
+
+struct UartReply {
+    int32_t m, b;
+};
+
+//    ""  (    ).
+//    USB-UART ,     .
+class SerialPort {
+private:
+    int fd = -1;
+    int baud_rate = 0;
+
+    static speed_t to_speed(int baud) {
+        switch (baud) {
+            case 9600: return B9600;
+            case 19200: return B19200;
+            case 38400: return B38400;
+            case 57600: return B57600;
+            case 115200: return B115200;
+            case 230400: return B230400;
+            case 460800: return B460800;
+            case 921600: return B921600;
+        }
+        throw std::runtime_error("Unsupported baud rate: " + std::to_string(baud));
+    }
+
+public:
+    SerialPort(const std::string& path, int baud) : baud_rate(baud) {
+        fd = ::open(path.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK);
+        if (fd < 0) throw std::runtime_error("Cannot open " + path + ": " + std::strerror(errno));
+
+        termios tio{};
+        if (tcgetattr(fd, &tio) != 0) {
+            ::close(fd);
+            throw std::runtime_error("tcgetattr failed for " + path);
+        }
+        cfmakeraw(&tio);
+        tio.c_cflag |= CLOCAL | CREAD;
+        tio.c_cflag &= ~(CSTOPB | PARENB);
+        cfsetispeed(&tio, to_speed(baud));
+        cfsetospeed(&tio, to_speed(baud));
+        if (tcsetattr(fd, TCSANOW, &tio) != 0) {
+            ::close(fd);
+            throw std::runtime_error("tcsetattr failed for " + path);
+        }
+    }
+
+    ~SerialPort() {
+        if (fd >= 0) ::close(fd);
+    }
+
+    SerialPort(const SerialPort&) = delete;
+    SerialPort& operator=(const SerialPort&) = delete;
+
+    int handle() const { return fd; }
+    int baud() const { return baud_rate; }
+
+    //  ;    
+    size_t write_some(const uint8_t* data, size_t size) {
+        ssize_t n = ::write(fd, data, size);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR) return 0;
+            throw std::runtime_error(std::string("Serial write failed: ") + std::strerror(errno));
+        }
+        return static_cast<size_t>(n);
+    }
+
+    //  ;    
+    size_t read_some(uint8_t* data, size_t size) {
+        ssize_t n = ::read(fd, data, size);
+        if (n < 0) {
+            if (errno == EAGAIN || errno == EINTR) return 0;
+            throw std::runtime_error(std::string("Serial read failed: ") + std::strerror(errno));
+        }
+        return static_cast<size_t>(n);
+    }
+
+    //   ; false -  
+    bool wait(bool for_write, int timeout_ms) {
+        pollfd pfd{fd, static_cast<short>(POLLIN | (for_write ? POLLOUT : 0)), 0};
+        int rc = ::poll(&pfd, 1, timeout_ms);
+        if (rc < 0 && errno != EINTR) throw std::runtime_error(std::string("poll failed: ") + std::strerror(errno));
+        return rc > 0;
+    }
+
+    void discard_input() { tcflush(fd, TCIFLUSH); }
+    void discard_output() { tcflush(fd, TCOFLUSH); }
+};
+
+//   .      ,
+//     ,      24  32 
+//  .      window :   ,
+//    ,      .
+//       (FSM  ).
+//
+//     :      24 ,
+//     .   canary_interval   
+//       .    
+// ;     ,  
+//    .     
+//       ,   ,
+//      .
+class PipelinedUartClient {
+public:
+    struct Options {
+        size_t window = 4;          //   .  4   : RX FIFO UARTLite - 16 
+        size_t canary_interval = 32; //     
+        int timeout_ms = 250;       //    ,     
+        int max_retries = 8;        //        
+    };
+
+    struct Stats {
+        size_t queries = 0;
+        size_t timeouts = 0;
+        size_t desyncs = 0;
+        size_t resyncs = 0;
+        size_t retransmitted = 0;
+        double seconds = 0.0;
+
+        double queries_per_second() const { return seconds > 0.0 ? queries / seconds : 0.0; }
+    };
+
+private:
+    static constexpr size_t CANARY = static_cast<size_t>(-1);
+
+    SerialPort& port;
+    Options options;
+    Stats stats;
+
+    //  :      ,    
+    //           (    )
+    UartQuery canary_query{{-734521, 4812377, 251983, 5237941, 913457, 4563219}};
+    UartReply canary_reply{};
+    bool canary_known = false;
+
+    void append_frame(std::vector<uint8_t>& tx, const UartQuery& query) {
+        size_t base = tx.size();
+        tx.resize(base + UartProtocol::QUERY_BYTES);
+        for (size_t w = 0; w < UartProtocol::QUERY_WORDS; ++w) {
+            UartProtocol::put_word(&tx[base + w * 4], query.coords[w]);
+        }
+    }
+
+    //   .        
+    // ""  .     ,  
+    //  :         S_IDLE.
+    bool resync() {
+        ++stats.resyncs;
+        port.discard_output();
+
+        //     ,        
+        //        USB-UART 
+        const auto reply_wait = UartProtocol::byte_time(port.baud()) * (UartProtocol::REPLY_BYTES + 2) +
+                                std::chrono::milliseconds(2);
+        const int quiet_ms = static_cast<int>(std::chrono::duration_cast<std::chrono::milliseconds>(reply_wait).count()) + 1;
+
+        //   :         
+        uint8_t sink[64];
+        while (port.wait(false, quiet_ms)) {
+            if (port.read_some(sink, sizeof(sink)) == 0) break;
+        }
+        port.discard_input();
+
+        const uint8_t filler = 0;
+        uint8_t reply[UartProtocol::REPLY_BYTES];
+        for (size_t sent = 0; sent < UartProtocol::QUERY_BYTES; ++sent) {
+            while (port.write_some(&filler, 1) == 0) port.wait(true, options.timeout_ms);
+
+            size_t got = 0;
+            auto deadline = std::chrono::steady_clock::now() + reply_wait;
+            while (std::chrono::steady_clock::now() < deadline && got < UartProtocol::REPLY_BYTES) {
+                if (port.wait(false, 1)) got += port.read_some(reply + got, sizeof(reply) - got);
+            }
+            if (got > 0) {
+                //    "-"    
+                while (got < UartProtocol::REPLY_BYTES && port.wait(false, options.timeout_ms)) {
+                    got += port.read_some(reply + got, sizeof(reply) - got);
+                }
+                port.discard_input();
+                return got == UartProtocol::REPLY_BYTES;
+            }
+        }
+        return false;
+    }
+
+    //     (   )
+    bool exchange(const UartQuery& query, UartReply& reply) {
+        std::vector<uint8_t> tx;
+        append_frame(tx, query);
+        size_t pos = 0;
+        while (pos < tx.size()) {
+            if (!port.wait(true, options.timeout_ms)) return false;
+            pos += port.write_some(tx.data() + pos, tx.size() - pos);
+        }
+        uint8_t rx[UartProtocol::REPLY_BYTES];
+        size_t got = 0;
+        while (got < sizeof(rx)) {
+            if (!port.wait(false, options.timeout_ms)) return false;
+            got += port.read_some(rx + got, sizeof(rx) - got);
+        }
+        reply.m = UartProtocol::get_word(rx);
+        reply.b = UartProtocol::get_word(rx + 4);
+        return true;
+    }
+
+    //        .
+    //   ,         .
+    void synchronize() {
+        for (int attempt = 0; attempt <= options.max_retries; ++attempt) {
+            if (!resync()) continue;
+            UartReply first, second;
+            if (!exchange(canary_query, first) || !exchange(canary_query, second)) continue;
+            if (first.m == second.m && first.b == second.b) {
+                canary_reply = first;
+                canary_known = true;
+                return;
+            }
+        }
+        throw std::runtime_error("UART link lost: board does not respond");
+    }
+
+public:
+    explicit PipelinedUartClient(SerialPort& serial) : PipelinedUartClient(serial, Options()) {}
+
+    PipelinedUartClient(SerialPort& serial, Options opts) : port(serial), options(opts) {
+        if (options.window == 0) options.window = 1;
+    }
+
+    const Stats& get_stats() const { return stats; }
+
+    //          
+    std::vector<UartReply> run(const std::vector<UartQuery>& queries) {
+        auto start = std::chrono::steady_clock::now();
+        if (!canary_known) synchronize();
+
+        std::vector<UartReply> replies(queries.size());
+        int failures_in_row = 0;
+
+        std::deque<size_t> pending;     //    ( ..  )
+        std::deque<size_t> in_flight;   // ,  ,   
+        std::vector<size_t> provisional; // ,      
+        for (size_t i = 0; i < queries.size(); ++i) pending.push_back(i);
+
+        std::vector<uint8_t> tx;
+        size_t tx_pos = 0;
+        uint8_t rx[UartProtocol::REPLY_BYTES];
+        size_t rx_len = 0;
+        size_t since_canary = 0;
+        size_t interval = options.canary_interval;
+        auto last_progress = std::chrono::steady_clock::now();
+
+        //  :   -   ,   
+        auto recover = [&]() {
+            if (++failures_in_row > options.max_retries) {
+                throw std::runtime_error("UART link is unstable: too many failures in a row");
+            }
+            std::vector<size_t> lost = provisional;
+            for (size_t idx : in_flight) if (idx != CANARY) lost.push_back(idx);
+            for (auto it = lost.rbegin(); it != lost.rend(); ++it) {
+                pending.push_front(*it);
+                ++stats.retransmitted;
+            }
+            provisional.clear();
+            in_flight.clear();
+            tx.clear();
+            tx_pos = 0;
+            rx_len = 0;
+            since_canary = 0;
+            interval = std::max<size_t>(1, interval / 2);
+            synchronize();
+            last_progress = std::chrono::steady_clock::now();
+        };
+
+        while (!pending.empty() || !in_flight.empty() || !provisional.empty()) {
+            // 1.    ;      
+            while (in_flight.size() < options.window) {
+                bool need_canary = interval > 0 &&
+                    (since_canary >= interval || (pending.empty() && since_canary > 0));
+                if (need_canary) {
+                    append_frame(tx, canary_query);
+                    in_flight.push_back(CANARY);
+                    since_canary = 0;
+                } else if (!pending.empty()) {
+                    size_t idx = pending.front();
+                    pending.pop_front();
+                    append_frame(tx, queries[idx]);
+                    in_flight.push_back(idx);
+                    ++since_canary;
+                } else {
+                    break;
+                }
+            }
+
+            // 2.       ,  
+            bool has_tx = tx_pos < tx.size();
+            port.wait(has_tx, 10);
+            if (has_tx) {
+                tx_pos += port.write_some(tx.data() + tx_pos, tx.size() - tx_pos);
+                if (tx_pos == tx.size()) { tx.clear(); tx_pos = 0; }
+            }
+
+            bool desync = false;
+            size_t n;
+            while (!desync && (n = port.read_some(rx + rx_len, sizeof(rx) - rx_len)) > 0) {
+                rx_len += n;
+                last_progress = std::chrono::steady_clock::now();
+                if (rx_len < UartProtocol::REPLY_BYTES) continue;
+                rx_len = 0;
+
+                if (in_flight.empty()) {
+                    desync = true; //    -   
+                    break;
+                }
+                size_t idx = in_flight.front();
+                in_flight.pop_front();
+                UartReply reply{UartProtocol::get_word(rx), UartProtocol::get_word(rx + 4)};
+
+                if (idx == CANARY) {
+                    if (reply.m != canary_reply.m || reply.b != canary_reply.b) {
+                        desync = true;
+                    } else {
+                        stats.queries += provisional.size();
+                        provisional.clear();
+                        failures_in_row = 0;
+                        interval = std::min(options.canary_interval, interval * 2);
+                    }
+                } else {
+                    replies[idx] = reply;
+                    if (options.canary_interval > 0) {
+                        provisional.push_back(idx);
+                    } else {
+                        ++stats.queries;
+                        failures_in_row = 0;
+                    }
+                }
+            }
+
+            // 3.    :     
+            if (desync) {
+                ++stats.desyncs;
+                recover();
+            } else if (!in_flight.empty() &&
+                       std::chrono::steady_clock::now() - last_progress > std::chrono::milliseconds(options.timeout_ms)) {
+                ++stats.timeouts;
+                recover();
+            }
+        }
+
+        stats.seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        return replies;
+    }
+};
@@ -0,0 +1,219 @@
+#pragma once
+#include <vector>
+#include <string>
+#include <fstream>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//     (*.nwb)    network_weights.txt / w*.mem.
+//
+//   (little-endian,     64 ):
+//   [0]    BundleHeader (64 )
+//   [64]   BundleRanges (64 )  - SCALE-  
+//   [128]  BundleLayerEntry[layer_count] ( 32 ),   64
+//   [...]     : int32,  row-major [][] -  
+//          QuantizedMlp    $readmemh,     .
+//   - FNV-1a 64  ,    .
+struct BundleHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t layer_count;
+    uint32_t flags;
+    int64_t scale;
+    uint64_t file_size;
+    uint64_t checksum;
+    uint8_t reserved[24];
+};
+
+struct BundleRanges {
+    double x_min, x_max;
+    double y_min, y_max;
+    double mb_min, mb_max;
+    uint8_t reserved[16];
+};
+
+struct BundleLayerEntry {
+    uint32_t inputs;
+    uint32_t outputs;
+    uint64_t weights_offset;
+    uint64_t bias_offset;
+    uint64_t reserved;
+};
+
+static_assert(sizeof(BundleHeader) == 64, "BundleHeader must be 64 bytes");
+static_assert(sizeof(BundleRanges) == 64, "BundleRanges must be 64 bytes");
+static_assert(sizeof(BundleLayerEntry) == 32, "BundleLayerEntry must be 32 bytes");
+
+//      
+struct BundleLayerData {
+    uint32_t inputs = 0;
+    uint32_t outputs = 0;
+    std::vector<int32_t> weights; // inputs * outputs, row-major [][]
+    std::vector<int32_t> bias;    // outputs
+};
+
+//  ,   .  -  mmap    
+//  ,     ,     
+//   .     - , verify_checksum().
+class WeightBundle {
+public:
+    static constexpr uint32_t MAGIC = 0x42574E4E; // "NNWB"
+    static constexpr uint32_t VERSION = 1;
+    static constexpr size_t ALIGNMENT = 64;
+
+private:
+    const uint8_t* base = nullptr;
+    size_t size = 0;
+
+    static size_t align_up(size_t value) { return (value + ALIGNMENT - 1) & ~(ALIGNMENT - 1); }
+
+    static uint64_t fnv1a(const uint8_t* data, size_t len) {
+        uint64_t hash = 0xcbf29ce484222325ULL;
+        for (size_t i = 0; i < len; ++i) {
+            hash ^= data[i];
+            hash *= 0x100000001b3ULL;
+        }
+        return hash;
+    }
+
+    void release() {
+        if (base) munmap(const_cast<uint8_t*>(base), size);
+        base = nullptr;
+        size = 0;
+    }
+
+    void check_range(uint64_t offset, uint64_t bytes) const {
+        if (offset % ALIGNMENT != 0 || offset > size || bytes > size - offset) {
+            throw std::runtime_error("Weight bundle is corrupted: layer data out of bounds");
+        }
+    }
+
+public:
+    WeightBundle() = default;
+
+    explicit WeightBundle(const std::string& filename) {
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0) throw std::runtime_error("Cannot open weight bundle: " + filename);
+        struct stat st{};
+        if (fstat(fd, &st) != 0 || st.st_size < static_cast<off_t>(2 * ALIGNMENT)) {
+            ::close(fd);
+            throw std::runtime_error("Weight bundle is too small: " + filename);
+        }
+        size = static_cast<size_t>(st.st_size);
+        void* mapped = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapped == MAP_FAILED) {
+            size = 0;
+            throw std::runtime_error("Cannot map weight bundle: " + filename);
+        }
+        base = static_cast<const uint8_t*>(mapped);
+
+        try {
+            const BundleHeader& h = header();
+            if (h.magic != MAGIC) throw std::runtime_error("Not a weight bundle: " + filename);
+            if (h.version != VERSION) throw std::runtime_error("Unsupported weight bundle version in " + filename);
+            if (h.file_size != size) throw std::runtime_error("Weight bundle is truncated: " + filename);
+            if (h.scale <= 0 || h.layer_count == 0) throw std::runtime_error("Invalid weight bundle header in " + filename);
+            check_range(2 * ALIGNMENT, align_up(h.layer_count * sizeof(BundleLayerEntry)));
+            for (uint32_t l = 0; l < h.layer_count; ++l) {
+                const BundleLayerEntry& e = layer(l);
+                check_range(e.weights_offset, static_cast<uint64_t>(e.inputs) * e.outputs * sizeof(int32_t));
+                check_range(e.bias_offset, static_cast<uint64_t>(e.outputs) * sizeof(int32_t));
+            }
+        } catch (...) {
+            release();
+            throw;
+        }
+    }
+
+    ~WeightBundle() { release(); }
+
+    WeightBundle(const WeightBundle&) = delete;
+    WeightBundle& operator=(const WeightBundle&) = delete;
+
+    WeightBundle(WeightBundle&& other) noexcept : base(other.base), size(other.size) {
+        other.base = nullptr;
+        other.size = 0;
+    }
+
+    WeightBundle& operator=(WeightBundle&& other) noexcept {
+        if (this != &other) {
+            release();
+            base = other.base;
+            size = other.size;
+            other.base = nullptr;
+            other.size = 0;
+        }
+        return *this;
+    }
+
+    const BundleHeader& header() const { return *reinterpret_cast<const BundleHeader*>(base); }
+    const BundleRanges& ranges() const { return *reinterpret_cast<const BundleRanges*>(base + ALIGNMENT); }
+    uint32_t layer_count() const { return header().layer_count; }
+
+    const BundleLayerEntry& layer(uint32_t index) const {
+        return reinterpret_cast<const BundleLayerEntry*>(base + 2 * ALIGNMENT)[index];
+    }
+
+    const int32_t* weights(uint32_t index) const {
+        return reinterpret_cast<const int32_t*>(base + layer(index).weights_offset);
+    }
+
+    const int32_t* bias(uint32_t index) const {
+        return reinterpret_cast<const int32_t*>(base + layer(index).bias_offset);
+    }
+
+    bool verify_checksum() const {
+        return fnv1a(base + sizeof(BundleHeader), size - sizeof(BundleHeader)) == header().checksum;
+    }
+
+    //  .         .
+    static void write(const std::string& filename, int64_t scale, const BundleRanges& ranges,
+                      const std::vector<BundleLayerData>& layers) {
+        if (layers.empty()) throw std::runtime_error("Cannot write an empty weight bundle");
+
+        size_t offset = 2 * ALIGNMENT + align_up(layers.size() * sizeof(BundleLayerEntry));
+        std::vector<BundleLayerEntry> table(layers.size());
+        for (size_t l = 0; l < layers.size(); ++l) {
+            const auto& layer = layers[l];
+            if (layer.weights.size() != static_cast<size_t>(layer.inputs) * layer.outputs || layer.bias.size() != layer.outputs) {
+                throw std::runtime_error("Layer data does not match its shape");
+            }
+            table[l] = {layer.inputs, layer.outputs, 0, 0, 0};
+            table[l].weights_offset = offset;
+            offset = align_up(offset + layer.weights.size() * sizeof(int32_t));
+            table[l].bias_offset = offset;
+            offset = align_up(offset + layer.bias.size() * sizeof(int32_t));
+        }
+
+        std::vector<uint8_t> image(offset, 0);
+        BundleHeader h{};
+        h.magic = MAGIC;
+        h.version = VERSION;
+        h.layer_count = static_cast<uint32_t>(layers.size());
+        h.scale = scale;
+        h.file_size = image.size();
+
+        BundleRanges r = ranges;
+        std::memset(r.reserved, 0, sizeof(r.reserved));
+        std::memcpy(image.data() + ALIGNMENT, &r, sizeof(r));
+        std::memcpy(image.data() + 2 * ALIGNMENT, table.data(), table.size() * sizeof(BundleLayerEntry));
+        for (size_t l = 0; l < layers.size(); ++l) {
+            std::memcpy(image.data() + table[l].weights_offset, layers[l].weights.data(), layers[l].weights.size() * sizeof(int32_t));
+            std::memcpy(image.data() + table[l].bias_offset, layers[l].bias.data(), layers[l].bias.size() * sizeof(int32_t));
+        }
+        h.checksum = fnv1a(image.data() + sizeof(BundleHeader), image.size() - sizeof(BundleHeader));
+        std::memcpy(image.data(), &h, sizeof(h));
+
+        std::ofstream outfile(filename, std::ios::binary | std::ios::trunc);
+        if (!outfile) throw std::runtime_error("Cannot create weight bundle: " + filename);
+        outfile.write(reinterpret_cast<const char*>(image.data()), static_cast<std::streamsize>(image.size()));
+        if (!outfile) throw std::runtime_error("Failed to write weight bundle: " + filename);
+    }
+};
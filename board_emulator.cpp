@@ -0,0 +1,146 @@
+#include <iostream>
+#include <string>
+#include <vector>
+#include <deque>
+#include <chrono>
+#include <thread>
+#include <random>
+#include <stdexcept>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "QuantizedMlp.h"
+#include "UartLink.h"
+
+//    Nexys A7  top_module  й3.
+//       FSM  :  24 ,
+//   --  neural_inference   8  .
+//  UART :  "  "  ,   baud.
+
+struct EmulatorConfig {
+    std::string weights_file = "network_weights.txt";
+    int baud = 115200;              // 0 -    
+    double drop_rate = 0.0;         //     ( )
+    std::chrono::microseconds compute_time{30}; // ~3000   100 
+    QuantizedMlp::ScaleMode scale_mode = QuantizedMlp::ScaleMode::Divide;
+};
+
+static EmulatorConfig parse_args(int argc, char* argv[]) {
+    EmulatorConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--weights") config.weights_file = next();
+        else if (arg == "--baud") config.baud = std::stoi(next());
+        else if (arg == "--drop") config.drop_rate = std::stod(next());
+        else if (arg == "--compute-us") config.compute_time = std::chrono::microseconds(std::stoi(next()));
+        else if (arg == "--pipelined-rtl") config.scale_mode = QuantizedMlp::ScaleMode::InvScaleShift;
+        else throw std::runtime_error("Unknown argument: " + arg);
+    }
+    return config;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        EmulatorConfig config = parse_args(argc, argv);
+
+        QuantizedMlp network;
+        network.load(config.weights_file);
+        network.set_scale_mode(config.scale_mode);
+
+        int master = posix_openpt(O_RDWR | O_NOCTTY);
+        if (master < 0 || grantpt(master) != 0 || unlockpt(master) != 0) {
+            throw std::runtime_error("Cannot create pseudo-terminal");
+        }
+        std::string slave_name = ptsname(master);
+
+        //       :       
+        int slave = ::open(slave_name.c_str(), O_RDWR | O_NOCTTY);
+        if (slave < 0) throw std::runtime_error("Cannot open " + slave_name);
+        termios tio{};
+        tcgetattr(slave, &tio);
+        cfmakeraw(&tio);
+        tcsetattr(slave, TCSANOW, &tio);
+        fcntl(master, F_SETFL, fcntl(master, F_GETFL) | O_NONBLOCK);
+
+        std::cout << slave_name << std::endl;
+        std::cerr << "  : " << slave_name
+                  << ",  " << config.baud << " , SCALE = " << network.get_scale() << std::endl;
+
+        using Clock = std::chrono::steady_clock;
+        const auto byte_time = config.baud > 0 ? UartProtocol::byte_time(config.baud) : Clock::duration::zero();
+
+        std::mt19937 noise(42);
+        std::uniform_real_distribution<double> coin(0.0, 1.0);
+
+        //  FSM:  ,     TX
+        uint8_t frame[UartProtocol::QUERY_BYTES];
+        size_t rx_byte_count = 0;
+        auto rx_line_free = Clock::now(); // ,  "" RX   
+        auto tx_line_free = Clock::now();
+
+        struct PendingReply { Clock::time_point due; uint8_t bytes[UartProtocol::REPLY_BYTES]; };
+        std::deque<PendingReply> tx_queue;
+        size_t frames = 0;
+
+        uint8_t buf[256];
+        while (true) {
+            int timeout_ms = -1;
+            if (!tx_queue.empty()) {
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(tx_queue.front().due - Clock::now());
+                timeout_ms = static_cast<int>(std::max<long long>(0, wait.count()));
+            }
+            pollfd pfd{master, POLLIN, 0};
+            ::poll(&pfd, 1, timeout_ms);
+
+            ssize_t n = ::read(master, buf, sizeof(buf));
+            for (ssize_t k = 0; k < n; ++k) {
+                //     ,    
+                rx_line_free = std::max(rx_line_free, Clock::now()) + byte_time;
+                if (config.drop_rate > 0.0 && coin(noise) < config.drop_rate) continue;
+
+                frame[rx_byte_count++] = buf[k];
+                if (rx_byte_count < UartProtocol::QUERY_BYTES) continue;
+                rx_byte_count = 0;
+
+                int32_t coords[UartProtocol::QUERY_WORDS];
+                for (size_t w = 0; w < UartProtocol::QUERY_WORDS; ++w) coords[w] = UartProtocol::get_word(frame + w * 4);
+                int32_t out[QuantizedMlp::OUTPUT_SIZE];
+                network.infer(coords, out);
+
+                PendingReply reply;
+                UartProtocol::put_word(reply.bytes, out[0]);
+                UartProtocol::put_word(reply.bytes + 4, out[1]);
+                auto ready = rx_line_free + config.compute_time;
+                tx_line_free = std::max(tx_line_free, ready) + byte_time * UartProtocol::REPLY_BYTES;
+                reply.due = tx_line_free;
+                tx_queue.push_back(reply);
+                if (++frames % 10000 == 0) std::cerr << " : " << frames << std::endl;
+            }
+
+            while (!tx_queue.empty() && tx_queue.front().due <= Clock::now()) {
+                const auto& reply = tx_queue.front();
+                size_t written = 0;
+                while (written < UartProtocol::REPLY_BYTES) {
+                    ssize_t w = ::write(master, reply.bytes + written, UartProtocol::REPLY_BYTES - written);
+                    if (w > 0) written += static_cast<size_t>(w);
+                    else std::this_thread::sleep_for(std::chrono::microseconds(100));
+                }
+                tx_queue.pop_front();
+            }
+        }
+    } catch (const std::exception& e) {
+        std::cerr << " : " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,201 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <chrono>
+#include <random>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cmath>
+
+#include "QuantizedMlp.h"
+#include "DaemonProtocol.h"
+
+//   neiro_daemon. --connections ,    ,
+//        ( ),     
+//  ,  .    
+//     ,   .  --weights
+//     - .
+//
+// : infer -        ( uart_client);
+// fit -   --queries      ;
+// process -    NeuroProcessor   y; stats -  .
+
+struct ClientConfig {
+    std::string socket_path = "/tmp/neiro.sock";
+    std::string mode = "infer";
+    std::string weights_file;
+    size_t connections = 4;
+    size_t requests = 10000;   //  
+    size_t queries = 1;        //    ( )  
+    QuantizedMlp::ScaleMode scale_mode = QuantizedMlp::ScaleMode::Divide; //    ( --weights)
+};
+
+static ClientConfig parse_args(int argc, char* argv[]) {
+    ClientConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--socket") config.socket_path = next();
+        else if (arg == "--weights") config.weights_file = next();
+        else if (arg == "--connections") config.connections = std::stoul(next());
+        else if (arg == "--requests") config.requests = std::stoul(next());
+        else if (arg == "--queries") config.queries = std::stoul(next());
+        else if (arg == "--pipelined-rtl") config.scale_mode = QuantizedMlp::ScaleMode::InvScaleShift;
+        else if (arg == "infer" || arg == "fit" || arg == "process" || arg == "stats") config.mode = arg;
+        else throw std::runtime_error("Usage: daemon_client [infer|fit|process|stats] [--socket PATH] [--connections C] "
+                                      "[--requests N] [--queries Q] [--weights network_weights.txt] [--pipelined-rtl]");
+    }
+    if (config.connections == 0 || config.queries == 0) throw std::runtime_error("--connections and --queries must be positive");
+    return config;
+}
+
+static void print_server_stats(const DaemonProtocol::StatsReply& s) {
+    std::cout << std::fixed << std::setprecision(1)
+              << ":  " << s.requests << ",    " << s.queries
+              << ",  " << s.batches << " ( " << s.mean_batch << ")"
+              << ",  p50/p99: " << s.p50_us << "/" << s.p99_us << " "
+              << ",   " << s.uptime << " " << std::endl;
+}
+
+struct WorkerResult {
+    std::vector<double> latencies_us;
+    size_t mismatches = 0;
+    size_t failures = 0;
+};
+
+//   :  ,  
+static void run_worker(const ClientConfig& config, const QuantizedMlp* reference, unsigned seed, WorkerResult& result) {
+    using Clock = std::chrono::steady_clock;
+    const int64_t SCALE = 100000;
+    std::mt19937 gen(seed);
+    std::uniform_real_distribution<> m_b_dist(-5.0, 5.0), x_dist(-10.0, 10.0);
+
+    DaemonConnection conn(config.socket_path);
+    std::vector<int32_t> coords(config.queries * 6), out(config.queries * 2), expected(2);
+    std::vector<std::pair<double, double>> points(config.queries < 2 ? 2 : config.queries);
+    std::vector<double> xs(config.queries), ys;
+    result.latencies_us.reserve(config.requests);
+
+    if (config.mode == "process" && conn.load(2.0, -1.0) != DaemonProtocol::Status::Ok) ++result.failures;
+
+    for (size_t r = 0; r < config.requests; ++r) {
+        double m = m_b_dist(gen), b = m_b_dist(gen);
+        if (config.mode == "infer") {
+            for (size_t q = 0; q < config.queries; ++q) {
+                for (int p = 0; p < 3; ++p) {
+                    double x = x_dist(gen);
+                    coords[q * 6 + p * 2 + 0] = static_cast<int32_t>(std::llround(x * SCALE));
+                    coords[q * 6 + p * 2 + 1] = static_cast<int32_t>(std::llround((m * x + b) * SCALE));
+                }
+            }
+        } else if (config.mode == "fit") {
+            for (auto& p : points) {
+                double x = x_dist(gen);
+                p = {x, m * x + b};
+            }
+        } else {
+            for (auto& x : xs) x = x_dist(gen);
+        }
+
+        auto started = Clock::now();
+        DaemonProtocol::Status status;
+        if (config.mode == "infer") {
+            status = conn.infer(coords.data(), config.queries, out.data());
+        } else if (config.mode == "fit") {
+            double fm = 0.0, fb = 0.0;
+            status = conn.fit(points, fm, fb);
+            if (status == DaemonProtocol::Status::Ok && (std::abs(fm - m) > 1e-9 || std::abs(fb - b) > 1e-9)) ++result.mismatches;
+        } else {
+            status = conn.process(xs, ys);
+            for (size_t i = 0; status == DaemonProtocol::Status::Ok && i < xs.size(); ++i) {
+                if (ys[i] != 2.0 * xs[i] - 1.0) ++result.mismatches;
+            }
+        }
+        result.latencies_us.push_back(std::chrono::duration<double, std::micro>(Clock::now() - started).count());
+        if (status != DaemonProtocol::Status::Ok) {
+            ++result.failures;
+            continue;
+        }
+
+        if (reference && config.mode == "infer") {
+            for (size_t q = 0; q < config.queries; ++q) {
+                reference->infer(coords.data() + q * 6, expected.data());
+                if (expected[0] != out[q * 2] || expected[1] != out[q * 2 + 1]) ++result.mismatches;
+            }
+        }
+    }
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        ClientConfig config = parse_args(argc, argv);
+
+        if (config.mode == "stats") {
+            DaemonConnection conn(config.socket_path);
+            print_server_stats(conn.stats());
+            return 0;
+        }
+
+        QuantizedMlp reference;
+        bool verify = !config.weights_file.empty();
+        if (verify) {
+            reference.load(config.weights_file);
+            reference.set_scale_mode(config.scale_mode);
+        }
+
+        std::cout << " " << config.mode << ": " << config.connections << "   "
+                  << config.requests << " , " << config.queries << "  ..." << std::endl;
+
+        std::vector<WorkerResult> results(config.connections);
+        std::vector<std::thread> workers;
+        auto started = std::chrono::steady_clock::now();
+        for (size_t c = 0; c < config.connections; ++c) {
+            workers.emplace_back([&, c] {
+                try {
+                    run_worker(config, verify ? &reference : nullptr, 2024 + static_cast<unsigned>(c), results[c]);
+                } catch (const std::exception& e) {
+                    std::cerr << " " << c << ": " << e.what() << std::endl;
+                    results[c].failures = config.requests;
+                }
+            });
+        }
+        for (auto& w : workers) w.join();
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - started).count();
+
+        std::vector<double> latencies;
+        size_t mismatches = 0, failures = 0;
+        for (const auto& r : results) {
+            latencies.insert(latencies.end(), r.latencies_us.begin(), r.latencies_us.end());
+            mismatches += r.mismatches;
+            failures += r.failures;
+        }
+        std::sort(latencies.begin(), latencies.end());
+        auto quantile = [&](double q) {
+            return latencies.empty() ? 0.0 : latencies[static_cast<size_t>(q * static_cast<double>(latencies.size() - 1))];
+        };
+
+        std::cout << std::fixed << std::setprecision(1)
+                  << "/: " << latencies.size() / seconds
+                  << ", /: " << latencies.size() * config.queries / seconds
+                  << " ( " << std::setprecision(3) << seconds << " )" << std::endl;
+        std::cout << std::setprecision(1) << " p50/p99/max: " << quantile(0.50) << "/" << quantile(0.99)
+                  << "/" << (latencies.empty() ? 0.0 : latencies.back()) << " " << std::endl;
+        std::cout << ": " << failures;
+        if (verify || config.mode != "infer") std::cout << ",   : " << mismatches;
+        std::cout << std::endl;
+
+        DaemonConnection conn(config.socket_path);
+        print_server_stats(conn.stats());
+        if (failures > 0 || mismatches > 0) return 2;
+    } catch (const std::exception& e) {
+        std::cerr << " : " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,189 @@
+#include <iostream>
+#include <vector>
+#include <random>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <string>
+#include <stdexcept>
+#include <chrono>
+#include <type_traits>
+
+#include "BatchGenerator.h"
+#include "MlpTraining.h"
+
+struct GeneratorConfig {
+    int steps = 80000;
+    double prune = 0.0;     //  RMS  ; 0 -  
+    int fine_tune = 4000;   //    
+    bool sweep = false;     //  /   
+    Precision precision = Precision::Double;
+    bool validate = false;  //  float:     ,   double
+    double tolerance = 0.01; //    m, b  
+};
+
+static GeneratorConfig parse_args(int argc, char* argv[]) {
+    GeneratorConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--steps") config.steps = std::stoi(next());
+        else if (arg == "--prune") config.prune = std::stod(next());
+        else if (arg == "--fine-tune") config.fine_tune = std::stoi(next());
+        else if (arg == "--sweep") config.sweep = true;
+        else if (arg == "--precision") {
+            std::string p = next();
+            if (p == "double") config.precision = Precision::Double;
+            else if (p == "float") config.precision = Precision::Float;
+            else if (p == "mixed") config.precision = Precision::Mixed;
+            else throw std::runtime_error("Precision must be double, float or mixed");
+        }
+        else if (arg == "--validate") config.validate = true;
+        else if (arg == "--tolerance") config.tolerance = std::stod(next());
+        else throw std::runtime_error("Usage: generate_weights [--steps N] [--prune T] [--fine-tune N] [--sweep] "
+                                      "[--precision double|float|mixed] [--validate] [--tolerance T]");
+    }
+    if (config.steps <= 0 || config.prune < 0.0 || config.fine_tune < 0 || config.tolerance < 0.0) throw std::runtime_error("Invalid arguments");
+    if (config.validate && config.precision == Precision::Double) {
+        throw std::runtime_error("--validate compares against double training and needs --precision float or mixed");
+    }
+    return config;
+}
+
+const double LEARNING_RATE = 0.001;
+const size_t BATCH_SIZE = 128;
+
+// steps     ,    first_step
+template<typename T,typename Acc> void train(Network<T>& net,const PhiloxLineGenerator& generator,uint64_t first_step,int steps,const PruneMasks<T>& masks,bool verbose){
+    //      (BatchGenerator.h),    ;
+    //     seed   ,     
+    BatchPipeline<T> pipeline(generator, BATCH_SIZE, first_step, static_cast<uint64_t>(steps));
+    Matrix<T> X_batch(BATCH_SIZE,INPUT_SIZE), Y_batch(BATCH_SIZE,OUTPUT_SIZE);
+    Workspace<T,Acc> workspace(BATCH_SIZE);
+    for (int step=0; step<steps; ++step) {
+        const auto& batch=pipeline.next();
+        std::copy(batch.X.begin(),batch.X.end(),X_batch.d.begin());
+        std::copy(batch.Y.begin(),batch.Y.end(),Y_batch.d.begin());
+        double loss=train_step(net,X_batch,Y_batch,LEARNING_RATE,masks,workspace);
+        if(verbose&&step%5000==0){std::cout<<" "<<std::setw(5)<<step<<", : "<<loss/BATCH_SIZE<<std::endl;}
+    }
+}
+
+template<typename T,typename Acc> int run(const GeneratorConfig& config) {
+    Network<T> net = make_network<T>();
+    int steps=config.steps;
+    PhiloxLineGenerator generator(1337, {M_B_MIN, M_B_MAX, X_MIN, X_MAX, Y_MIN, Y_MAX});
+
+    std::cout << "    ..." << std::endl;
+    auto start = std::chrono::steady_clock::now();
+    train<T,Acc>(net, generator, 0, steps, PruneMasks<T>(), true);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::cout << ": " << std::fixed << std::setprecision(2) << seconds << " , " << std::setprecision(0)
+              << steps / seconds << " /" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+
+    //   -  steps (   );    -
+    //   ,    
+    const size_t EVAL_SIZE = 8192;
+    EvalSet eval{Matrix<double>(EVAL_SIZE,INPUT_SIZE), Matrix<double>(EVAL_SIZE,OUTPUT_SIZE)};
+    generator.generate(static_cast<uint64_t>(steps), 0, EVAL_SIZE, eval.X.d.data(), eval.Y.d.data());
+
+    //  float-:   ,     double; 
+    //      .     
+    // ,   ,   
+    int status = 0;
+    if (config.validate && !std::is_same<T,double>::value) {
+        std::cout << ":      double..." << std::endl;
+        Network<double> reference = make_network<double>();
+        train<double,double>(reference, generator, 0, steps, PruneMasks<double>(), false);
+        auto q_ref = quantize_network(reference), q_net = quantize_network(net);
+        int64_t max_diff = 0;
+        for (size_t l = 0; l < q_ref.size(); ++l) {
+            for (size_t i = 0; i < q_ref[l].weights.size(); ++i) max_diff = std::max<int64_t>(max_diff, std::abs(int64_t(q_ref[l].weights[i]) - q_net[l].weights[i]));
+            for (size_t i = 0; i < q_ref[l].bias.size(); ++i) max_diff = std::max<int64_t>(max_diff, std::abs(int64_t(q_ref[l].bias[i]) - q_net[l].bias[i]));
+        }
+        std::vector<double> p_ref = quantized_predictions(q_ref, eval), p_net = quantized_predictions(q_net, eval);
+        double diff_m = 0, diff_b = 0;
+        for (size_t i = 0; i < EVAL_SIZE; ++i) { diff_m += std::abs(p_ref[i*2] - p_net[i*2]); diff_b += std::abs(p_ref[i*2+1] - p_net[i*2+1]); }
+        diff_m /= EVAL_SIZE; diff_b /= EVAL_SIZE;
+        Accuracy a_ref = evaluate<double,double>(reference, eval), a_net = evaluate<T,Acc>(net, eval);
+        bool ok = diff_m <= config.tolerance && diff_b <= config.tolerance;
+        std::cout << std::fixed << std::setprecision(4)
+                  << ".   : " << max_diff << " (" << static_cast<double>(max_diff) / SCALE_FACTOR << ")" << std::endl
+                  << "   : m " << diff_m << ", b " << diff_b << " ( " << config.tolerance << ")" << std::endl
+                  << "  : double - m " << a_ref.q_m << ", b " << a_ref.q_b
+                  << "; float - m " << a_net.q_m << ", b " << a_net.q_b << std::endl
+                  << " " << (ok ? "" : " ") << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+        if (!ok) status = 2;
+    }
+
+    if (config.prune > 0.0 || config.sweep) {
+        auto prune_and_tune = [&](double threshold) {
+            Network<T> pruned = net;
+            PruneMasks<T> masks = prune_network(pruned, threshold);
+            train<T,Acc>(pruned, generator, static_cast<uint64_t>(steps) + 1, config.fine_tune, masks, false);
+            return pruned;
+        };
+
+        size_t dense_macs = INPUT_SIZE*HIDDEN1_SIZE + HIDDEN1_SIZE*HIDDEN2_SIZE + HIDDEN2_SIZE*OUTPUT_SIZE;
+        auto report = [&](const std::string& name, const Network<T>& n) {
+            Accuracy acc = evaluate<T,Acc>(n, eval);
+            size_t macs = count_macs(n);
+            std::cout << std::setw(8) << name << std::setw(6) << macs << std::setw(8) << std::fixed << std::setprecision(1)
+                      << 100.0 * macs / dense_macs << "%" << std::setprecision(4) << std::setw(10) << acc.m << std::setw(10) << acc.b
+                      << std::setw(10) << acc.q_m << std::setw(10) << acc.q_b << std::endl;
+            std::cout.unsetf(std::ios::fixed);
+        };
+
+        std::cout << "    ( m, b -    " << EVAL_SIZE << " ,  "
+                  << config.fine_tune << " ):" << std::endl;
+        std::cout << "      MAC         m         b     .m   .b" << std::endl;
+        //       -       
+        report("", prune_and_tune(0.0));
+        if (config.sweep) {
+            for (double threshold : {0.05, 0.08, 0.1, 0.12, 0.15, 0.2}) {
+                if (threshold == config.prune) continue;
+                std::ostringstream name; name << threshold;
+                report(name.str(), prune_and_tune(threshold));
+            }
+        }
+        if (config.prune > 0.0) {
+            net = prune_and_tune(config.prune);
+            std::ostringstream name; name << config.prune << "*";
+            report(name.str(), net);
+            std::cout << "    " << config.prune << std::endl;
+        }
+    }
+    
+    //     
+    std::cout << "    ..." << std::endl;
+    std::vector<BundleLayerData> quantized = quantize_network(net);
+    
+    save_weights(quantized);
+
+    std::cout << "    ." << std::endl;
+    std::cout << " : " << SCALE_FACTOR << std::endl;
+    
+    return status;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        GeneratorConfig config = parse_args(argc, argv);
+        switch (config.precision) {
+        case Precision::Float: return run<float, float>(config);
+        case Precision::Mixed: return run<float, double>(config);
+        default: return run<double, double>(config);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << " : " << e.what() << std::endl;
+        return 1;
+    }
+}
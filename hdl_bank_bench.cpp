@@ -0,0 +1,90 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <stdexcept>
+
+#include "ApproximatorBank.h"
+
+//    :      ,
+//   prak1.cpp (EPOCHS ).     
+//   ApproximatorBank  ,    .
+
+struct BenchConfig {
+    size_t channels = 4096;
+    size_t points = 16;
+    int epochs = 500;
+};
+
+static BenchConfig parse_args(int argc, char* argv[]) {
+    BenchConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--channels") config.channels = std::stoul(next());
+        else if (arg == "--points") config.points = std::stoul(next());
+        else if (arg == "--epochs") config.epochs = std::stoi(next());
+        else throw std::runtime_error("Usage: hdl_bank_bench [--channels N] [--points N] [--epochs N]");
+    }
+    return config;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        BenchConfig config = parse_args(argc, argv);
+        size_t n = config.channels;
+
+        //      ;  x   
+        std::mt19937 gen(7);
+        std::uniform_real_distribution<> m_b_dist(-5.0, 5.0), x_dist(-10.0, 10.0), noise(-0.5, 0.5);
+        std::vector<long long> xs(config.points * n), ys(config.points * n);
+        for (size_t c = 0; c < n; ++c) {
+            double m = m_b_dist(gen), b = m_b_dist(gen);
+            for (size_t p = 0; p < config.points; ++p) {
+                double x = x_dist(gen);
+                xs[p * n + c] = double_to_fixed(x);
+                ys[p * n + c] = double_to_fixed(m * x + b + noise(gen));
+            }
+        }
+
+        std::vector<LinearApproximatorHDL> scalar(n);
+        auto start = std::chrono::steady_clock::now();
+        for (size_t c = 0; c < n; ++c) {
+            for (int e = 0; e < config.epochs; ++e) {
+                for (size_t p = 0; p < config.points; ++p) scalar[c].update(xs[p * n + c], ys[p * n + c]);
+            }
+        }
+        double scalar_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        ApproximatorBank bank(n);
+        start = std::chrono::steady_clock::now();
+        bank.train(xs.data(), ys.data(), config.points, config.epochs);
+        double bank_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        size_t mismatches = 0;
+        for (size_t c = 0; c < n; ++c) {
+            if (bank.getCoeffsFixed(c) != scalar[c].getCoeffsFixed()) ++mismatches;
+        }
+
+        double updates = static_cast<double>(n) * config.points * config.epochs;
+        std::cout << ": " << n << ", : " << config.points << ", : " << config.epochs
+                  << ",  : " << ApproximatorBank::lanes() << std::endl;
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << ": " << updates / scalar_seconds / 1e6 << "  /" << std::endl;
+        std::cout << ":     " << updates / bank_seconds / 1e6 << "  / (x"
+                  << std::setprecision(2) << scalar_seconds / bank_seconds << ")" << std::endl;
+        auto [m, b] = bank.getCoeffsDouble(0);
+        std::cout << std::setprecision(4) << " 0: m = " << m << ", b = " << b << std::endl;
+        std::cout << "   : " << mismatches << "  " << n << std::endl;
+        if (mismatches > 0) return 2;
+    } catch (const std::exception& e) {
+        std::cerr << " : " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
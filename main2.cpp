@@ -10,18 +10,70 @@
 #include <thread>
 #include <mutex>
 #include <optional>
+#include <tuple>
 
 #include <SDL2/SDL.h>
 
 //    
 #include "NeuroProcessor.h"
-#include "Trainer.h"
+#include "FitMetrics.h"
+#include "RobustFit.h"
+#include "Journal.h"
+#include "EventTrace.h"
+#include "LineFitPipelines.h"
 
 // ---       ---
 std::mutex g_data_mutex;
 std::vector<std::pair<double, double>> g_points;
 std::optional<std::pair<double, double>> g_new_point;
-constexpr size_t MAX_POINTS = 1000; //    
+FitTracker g_fit; //   g_points   :     
+RobustRegressor g_robust; //     -   
+
+//   ,      -  LineFitPipelines.h:   
+// trace_replay   main2
+using Main2Fit::FitMode;
+using Main2Fit::MAX_POINTS;
+FitMode g_fit_mode = FitMode::Ols;
+bool g_refit = false; //   -  
+
+// ---     ---
+constexpr const char* STATE_FILE = "main2_state"; // main2_state.journal  main2_state.snap
+constexpr size_t SNAPSHOT_EVERY = 100;            //   N  
+
+Snapshot make_snapshot() {
+    std::vector<JournalPoint> points;
+    points.reserve(g_points.size());
+    for (const auto& p : g_points) points.push_back({p.first, p.second});
+    Snapshot snapshot;
+    snapshot.add(SnapshotTag::Points, points);
+    snapshot.add(SnapshotTag::LineStats, g_fit.get_stats());
+    snapshot.add(SnapshotTag::FitResiduals, g_fit.export_residuals());
+    return snapshot;
+}
+
+//  +  .    ,    - .
+void restore_state(const StateJournal::Recovery& recovery) {
+    std::lock_guard<std::mutex> lock(g_data_mutex);
+    for (const auto& p : recovery.snapshot.get<JournalPoint>(SnapshotTag::Points)) g_points.push_back({p.x, p.y});
+    auto stats = recovery.snapshot.get<LineStats>(SnapshotTag::LineStats);
+    if (!stats.empty()) {
+        g_fit.restore(stats[0], recovery.snapshot.get<uint64_t>(SnapshotTag::FitResiduals));
+    } else {
+        for (const auto& p : g_points) g_fit.add(p.first, p.second);
+    }
+    for (const auto& p : recovery.tail) {
+        g_points.push_back({p.x, p.y});
+        g_fit.add(p.x, p.y);
+    }
+    for (const auto& p : g_points) g_robust.add(p.first, p.second);
+}
+
+//       (  g_data_mutex).
+//  -  O(1)  ,   -    .
+//  inliers -    , 0 -    .
+std::pair<double, double> solve_weights(size_t* inliers = nullptr) {
+    return Main2Fit::solve(g_fit_mode, g_fit, g_robust, inliers);
+}
 
 // ---    ---
 // ---  "VGA"  ---
@@ -121,6 +173,17 @@ struct CoordMapper {
 // ---    ---
 
 
+//   .  -  g_data_mutex:    
+// ,         .
+void print_fit_metrics(const FitMetrics& fm) {
+    if (!fm.valid) {
+        printf(":     (%llu)\n", static_cast<unsigned long long>(fm.count));
+        return;
+    }
+    printf(": n = %llu, RMSE = %.4f, R^2 = %.4f, || . = %.4f, p50/p90/p99 = %.4f/%.4f/%.4f\n",
+           static_cast<unsigned long long>(fm.count), fm.rmse, fm.r2, fm.mean_abs_residual, fm.p50, fm.p90, fm.p99);
+}
+
 // ---     (  ) ---
 void input_thread_func() {
     std::string line;
@@ -129,6 +192,32 @@ void input_thread_func() {
         if (!std::getline(std::cin, line) || line == "stop" || line == "exit" || line == "q") {
             break;
         }
+        if (line == "metrics" || line == "m") {
+            FitMetrics fm;
+            {
+                std::lock_guard<std::mutex> lock(g_data_mutex);
+                fm = g_fit.metrics();
+            }
+            print_fit_metrics(fm);
+            continue;
+        }
+        std::stringstream words(line);
+        std::string word, name, extra;
+        words >> word;
+        if (word == "mode") {
+            //     mode: "modeols"  "mode ols x" - 
+            if (!(words >> name) || (words >> extra)) name.clear();
+            FitMode mode;
+            if (!Main2Fit::parse_mode(name, mode)) {
+                std::cerr << " :  'mode ols', 'mode ransac'  'mode huber'." << std::endl;
+                continue;
+            }
+            trace_event(TraceEvent::Command, static_cast<double>(Main2Fit::trace_command(mode)));
+            std::lock_guard<std::mutex> lock(g_data_mutex);
+            g_fit_mode = mode;
+            g_refit = true;
+            continue;
+        }
 
         std::stringstream ss(line);
         double x, y;
@@ -138,10 +227,14 @@ void input_thread_func() {
             continue;
         }
 
-        std::lock_guard<std::mutex> lock(g_data_mutex);
-        if (g_points.size() < MAX_POINTS) {
-            g_new_point = {x, y};
-        } else {
+        trace_event(TraceEvent::Input, x, y);
+        bool accepted;
+        {
+            std::lock_guard<std::mutex> lock(g_data_mutex);
+            accepted = g_points.size() < MAX_POINTS;
+            if (accepted) g_new_point = {x, y};
+        }
+        if (!accepted) {
             std::cout << "   " << MAX_POINTS << " .    ." << std::endl;
         }
     }
@@ -150,34 +243,92 @@ void input_thread_func() {
 // ---   ---
 int main(int argc, char* argv[]) {
     try {
+        TraceSession trace("main2"); // NEIRO_TRACE=<> -    (EventTrace.h)
         VgaSimulator vga;
         NeuroProcessor neuro_processor;
 
+        StateJournal journal(STATE_FILE);
+        auto recovery = journal.recover();
+        restore_state(recovery);
+        size_t points_since_snapshot = recovery.tail.size();
+        if (recovery.lost > 0) {
+            printf(":   (     ),  : %llu\n",
+                   static_cast<unsigned long long>(recovery.lost));
+        }
+        for (const auto& p : g_points) trace_event(TraceEvent::Restored, p.first, p.second);
+        if (!g_points.empty()) {
+            auto [m, b] = solve_weights();
+            neuro_processor.load_weights(m, b);
+            printf(" : %zu ( : %zu)  %.2f , m = %.4f, b = %.4f\n",
+                   g_points.size(), recovery.tail.size(), recovery.milliseconds, m, b);
+        }
+
         std::cout << "    ." << std::endl;
         std::cout << "  : " << MAX_POINTS << std::endl;
         std::cout << "   'stop'     ." << std::endl;
+        std::cout << " 'metrics'  RMSE, R^2   ." << std::endl;
+        std::cout << " 'mode ols|ransac|huber'    (    )." << std::endl;
 
         std::thread input_thread(input_thread_func);
         input_thread.detach();
 
         bool running = true;
+        std::string journal_error; //     
         while (running) {
             if (!vga.process_events()) {
                 running = false;
             }
 
+            //    ,    
+            bool added = false, refitted = false;
+            size_t inliers = 0, point_count = 0;
+            FitMode mode = FitMode::Ols;
+            FitMetrics fm;
+            double new_m = 0.0, new_b = 0.0;
             {
                 std::lock_guard<std::mutex> lock(g_data_mutex);
                 if (g_new_point) {
+                    trace_event(TraceEvent::Handoff, g_new_point->first, g_new_point->second);
                     g_points.push_back(*g_new_point);
+                    g_fit.add(g_new_point->first, g_new_point->second);
+                    g_robust.add(g_new_point->first, g_new_point->second);
+                    journal.append(g_new_point->first, g_new_point->second);
                     g_new_point.reset();
+                    if (++points_since_snapshot >= SNAPSHOT_EVERY) {
+                        journal.checkpoint(make_snapshot());
+                        points_since_snapshot = 0;
+                    }
 
-                    std::cout << "  .  ..." << std::endl;
-                    auto [new_m, new_b] = Trainer::calculate_weights_normal_equation(g_points);
+                    added = true;
+                    g_refit = true;
+                }
+                if (g_refit) {
+                    g_refit = false;
+                    refitted = true;
+                    trace_event(TraceEvent::TrainBegin, static_cast<double>(g_points.size()));
+                    //  -     ,   Trainer,   O(1)
+                    std::tie(new_m, new_b) = solve_weights(&inliers);
                     neuro_processor.load_weights(new_m, new_b);
-                    printf("   : m = %.4f, b = %.4f\n", new_m, new_b);
+                    trace_event(TraceEvent::TrainEnd, new_m, new_b);
+                    mode = g_fit_mode;
+                    point_count = g_points.size();
+                    fm = g_fit.metrics();
                 }
             }
+            if (added) std::cout << "  .  ..." << std::endl;
+            if (refitted) {
+                if (inliers > 0) printf("%s:  %zu  %zu\n", Main2Fit::mode_name(mode), inliers, point_count);
+                printf("    (%s): m = %.4f, b = %.4f\n", Main2Fit::mode_name(mode), new_m, new_b);
+                print_fit_metrics(fm);
+            }
+
+            //     ,     :    
+            std::string error = journal.last_error();
+            if (error != journal_error) {
+                if (!error.empty()) std::cerr << ":    (" << error << "),      ." << std::endl;
+                else std::cout << "  ." << std::endl;
+                journal_error = error;
+            }
 
             auto [m, b] = neuro_processor.get_coeffs();
 
@@ -187,6 +338,7 @@ int main(int argc, char* argv[]) {
                 points_copy = g_points;
             }
 
+            trace_event(TraceEvent::RenderBegin, static_cast<double>(points_copy.size()));
             CoordMapper mapper(points_copy, m, b);
             vga.clear(0xFF101010);
 
@@ -206,9 +358,16 @@ int main(int argc, char* argv[]) {
             }
 
             vga.present();
+            trace_event(TraceEvent::RenderEnd);
             SDL_Delay(16);
         }
 
+        {
+            std::lock_guard<std::mutex> lock(g_data_mutex);
+            if (points_since_snapshot > 0) journal.checkpoint(make_snapshot());
+        }
+        journal.flush();
+
     } catch (const std::runtime_error& e) {
         std::cerr << " : " << e.what() << std::endl;
         return 1;
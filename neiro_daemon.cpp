@@ -0,0 +1,553 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <cerrno>
+#include <csignal>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+#include "QuantizedMlp.h"
+#include "NeuroProcessor.h"
+#include "LineStats.h"
+#include "FitMetrics.h"
+#include "DaemonProtocol.h"
+
+//  : , -     Unix-
+// ( - DaemonProtocol.h). -       poll;
+// Fit, Load, Process  Stats      .   
+//         QuantizedMlp::infer_batch 
+// ,         ,    .
+//
+//  ,      :
+//   -  --max-batch ;
+//   -        --budget-us (  
+//      ,    );
+//   -    :       
+//       (  ,    );
+//   -   :        
+//      .
+//         ,    
+//   .
+//
+//           
+// ;  -   FitMetrics.h.
+
+using Clock = std::chrono::steady_clock;
+
+struct DaemonConfig {
+    std::string socket_path = "/tmp/neiro.sock";
+    std::string weights_file = "network_weights.txt";
+    bool no_model = false;
+    std::chrono::microseconds budget{200};
+    size_t max_batch = 256;
+    int report_sec = 5;             // 0 -   
+    QuantizedMlp::ScaleMode scale_mode = QuantizedMlp::ScaleMode::Divide;
+};
+
+static DaemonConfig parse_args(int argc, char* argv[]) {
+    DaemonConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--socket") config.socket_path = next();
+        else if (arg == "--weights") config.weights_file = next();
+        else if (arg == "--no-model") config.no_model = true;
+        else if (arg == "--budget-us") config.budget = std::chrono::microseconds(std::stoi(next()));
+        else if (arg == "--max-batch") config.max_batch = std::stoul(next());
+        else if (arg == "--report-sec") config.report_sec = std::stoi(next());
+        else if (arg == "--pipelined-rtl") config.scale_mode = QuantizedMlp::ScaleMode::InvScaleShift;
+        else throw std::runtime_error("Unknown argument: " + arg);
+    }
+    if (config.max_batch == 0) throw std::runtime_error("--max-batch must be positive");
+    return config;
+}
+
+static volatile std::sig_atomic_t g_stop = 0;
+
+static void on_signal(int) { g_stop = 1; }
+
+static double micros(Clock::duration d) {
+    return std::chrono::duration<double, std::micro>(d).count();
+}
+
+//  .      -,  -
+//    ,    .
+struct Connection {
+    int fd = -1;
+    std::vector<uint8_t> in;
+    std::mutex out_mutex;
+    std::vector<uint8_t> out;
+    bool closed = false;      //  out_mutex:     
+    uint32_t pending = 0;     //      (  MicroBatcher)
+
+    void reply(DaemonProtocol::Op op, DaemonProtocol::Status status, uint32_t id, const uint8_t* payload, size_t length) {
+        std::lock_guard<std::mutex> lock(out_mutex);
+        if (!closed) DaemonProtocol::append_frame(out, op, status, id, payload, length);
+    }
+};
+
+//    :    ( Stats)    
+class ServerStats {
+private:
+    struct Window {
+        uint64_t requests = 0;
+        uint64_t queries = 0;
+        uint64_t batches = 0;
+        ResidualSketch latency;
+        Clock::time_point start = Clock::now();
+    };
+
+    mutable std::mutex mutex;
+    Window total;
+    Window window;
+
+    static DaemonProtocol::StatsReply summarize(const Window& w) {
+        DaemonProtocol::StatsReply s;
+        s.requests = w.requests;
+        s.queries = w.queries;
+        s.batches = w.batches;
+        s.uptime = std::chrono::duration<double>(Clock::now() - w.start).count();
+        s.p50_us = w.latency.quantile(0.50);
+        s.p99_us = w.latency.quantile(0.99);
+        s.requests_per_sec = s.uptime > 0.0 ? static_cast<double>(w.requests) / s.uptime : 0.0;
+        s.mean_batch = w.batches > 0 ? static_cast<double>(w.queries) / static_cast<double>(w.batches) : 0.0;
+        return s;
+    }
+
+public:
+    void record(double latency_us) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Window* w : {&total, &window}) {
+            ++w->requests;
+            w->latency.add(latency_us);
+        }
+    }
+
+    void record_batch(const std::vector<double>& latencies_us, size_t queries) {
+        std::lock_guard<std::mutex> lock(mutex);
+        for (Window* w : {&total, &window}) {
+            w->requests += latencies_us.size();
+            w->queries += queries;
+            ++w->batches;
+            for (double l : latencies_us) w->latency.add(l);
+        }
+    }
+
+    DaemonProtocol::StatsReply snapshot() const {
+        std::lock_guard<std::mutex> lock(mutex);
+        return summarize(total);
+    }
+
+    //     ;   
+    DaemonProtocol::StatsReply take_window() {
+        std::lock_guard<std::mutex> lock(mutex);
+        DaemonProtocol::StatsReply s = summarize(window);
+        window = Window();
+        return s;
+    }
+};
+
+class MicroBatcher {
+private:
+    struct Request {
+        std::shared_ptr<Connection> conn;
+        uint32_t id;
+        uint32_t count;
+        Clock::time_point arrival;
+    };
+
+    const QuantizedMlp& network;
+    const DaemonConfig& config;
+    ServerStats& stats;
+    std::function<void()> wake_io;
+
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::deque<Request> queue;
+    std::vector<int32_t> coords;      //   ,  6 
+    size_t queued = 0;                //     
+    size_t connections = 0;           //  
+    size_t busy_connections = 0;      //      
+    double arrival_gap_us = 1e9;      //      Infer
+    double cost_per_query_us = 0.0;   //      
+    Clock::time_point last_arrival{};
+    bool stopping = false;
+
+    std::thread worker;
+
+    bool should_dispatch(Clock::time_point now) const {
+        if (queued >= config.max_batch || stopping) return true;
+        if (busy_connections >= connections) return true;
+        Clock::time_point deadline = dispatch_deadline();
+        return now >= deadline || micros(deadline - now) < arrival_gap_us;
+    }
+
+    Clock::time_point dispatch_deadline() const {
+        auto reserve = std::chrono::microseconds(static_cast<int64_t>(cost_per_query_us * static_cast<double>(queued)));
+        return queue.front().arrival + config.budget - reserve;
+    }
+
+    void run() {
+        std::vector<Request> batch;
+        std::vector<int32_t> batch_coords, batch_out;
+        std::vector<uint8_t> payload;
+        std::vector<double> latencies;
+
+        std::unique_lock<std::mutex> lock(mutex);
+        while (true) {
+            cv.wait(lock, [&] { return stopping || !queue.empty(); });
+            if (queue.empty()) return;
+            while (!should_dispatch(Clock::now())) cv.wait_until(lock, dispatch_deadline());
+
+            //  ,     (    )
+            size_t queries = 0;
+            batch.clear();
+            while (!queue.empty() && (batch.empty() || queries + queue.front().count <= config.max_batch)) {
+                queries += queue.front().count;
+                batch.push_back(std::move(queue.front()));
+                queue.pop_front();
+            }
+            batch_coords.assign(coords.begin(), coords.begin() + static_cast<std::ptrdiff_t>(queries * 6));
+            coords.erase(coords.begin(), coords.begin() + static_cast<std::ptrdiff_t>(queries * 6));
+            queued -= queries;
+            lock.unlock();
+
+            batch_out.resize(queries * 2);
+            auto started = Clock::now();
+            network.infer_batch(batch_coords.data(), queries, batch_out.data());
+            auto finished = Clock::now();
+
+            latencies.clear();
+            size_t offset = 0;
+            for (const Request& r : batch) {
+                payload.resize(r.count * DaemonProtocol::REPLY_BYTES);
+                for (size_t i = 0; i < r.count * 2; ++i) DaemonProtocol::put_i32(payload.data() + i * 4, batch_out[offset * 2 + i]);
+                r.conn->reply(DaemonProtocol::Op::Infer, DaemonProtocol::Status::Ok, r.id, payload.data(), payload.size());
+                latencies.push_back(micros(Clock::now() - r.arrival));
+                offset += r.count;
+            }
+            wake_io();
+            stats.record_batch(latencies, queries);
+
+            lock.lock();
+            double cost = micros(finished - started) / static_cast<double>(queries);
+            cost_per_query_us = cost_per_query_us > 0.0 ? 0.9 * cost_per_query_us + 0.1 * cost : cost;
+            for (const Request& r : batch) {
+                if (--r.conn->pending == 0) --busy_connections;
+            }
+        }
+    }
+
+public:
+    MicroBatcher(const QuantizedMlp& network, const DaemonConfig& config, ServerStats& stats, std::function<void()> wake_io)
+        : network(network), config(config), stats(stats), wake_io(std::move(wake_io)) {
+        worker = std::thread([this] { run(); });
+    }
+
+    ~MicroBatcher() { stop(); }
+
+    //       
+    void stop() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        cv.notify_one();
+        if (worker.joinable()) worker.join();
+    }
+
+    void set_connections(size_t count) {
+        std::lock_guard<std::mutex> lock(mutex);
+        connections = count;
+    }
+
+    void submit(const std::shared_ptr<Connection>& conn, uint32_t id, const uint8_t* payload, uint32_t count, Clock::time_point arrival) {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (last_arrival != Clock::time_point{}) {
+            double gap = micros(arrival - last_arrival);
+            arrival_gap_us = arrival_gap_us < 1e9 ? 0.9 * arrival_gap_us + 0.1 * gap : gap;
+        }
+        last_arrival = arrival;
+
+        for (size_t i = 0; i < static_cast<size_t>(count) * 6; ++i) coords.push_back(DaemonProtocol::get_i32(payload + i * 4));
+        bool was_empty = queue.empty();
+        queue.push_back(Request{conn, id, count, arrival});
+        queued += count;
+        if (conn->pending++ == 0) ++busy_connections;
+        //      ;   ,   
+        //   
+        if (was_empty || queued >= config.max_batch || busy_connections >= connections) cv.notify_one();
+    }
+};
+
+class DaemonServer {
+private:
+    const DaemonConfig& config;
+    const QuantizedMlp* network;
+    NeuroProcessor processor;
+    ServerStats stats;
+
+    int listen_fd = -1;
+    int wake_pipe[2] = {-1, -1};
+    std::vector<std::shared_ptr<Connection>> connections;
+    std::unique_ptr<MicroBatcher> batcher;
+
+    void wake() {
+        uint8_t b = 1;
+        ssize_t ignored = ::write(wake_pipe[1], &b, 1); //   -    
+        (void)ignored;
+    }
+
+    void accept_connections() {
+        while (true) {
+            int fd = ::accept4(listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                return; // EAGAIN    
+            }
+            auto conn = std::make_shared<Connection>();
+            conn->fd = fd;
+            connections.push_back(conn);
+        }
+    }
+
+    void handle_frame(const std::shared_ptr<Connection>& conn, const DaemonProtocol::FrameHeader& h, const uint8_t* payload) {
+        using namespace DaemonProtocol;
+        auto arrival = Clock::now();
+        auto answer = [&](Status status, const uint8_t* data, size_t length) {
+            conn->reply(h.op, status, h.id, data, length);
+            stats.record(micros(Clock::now() - arrival));
+        };
+
+        switch (h.op) {
+            case Op::Infer: {
+                if (h.length == 0 || h.length % QUERY_BYTES != 0) return answer(Status::BadRequest, nullptr, 0);
+                if (!network) return answer(Status::NoModel, nullptr, 0);
+                batcher->submit(conn, h.id, payload, h.length / QUERY_BYTES, arrival);
+                return;
+            }
+            case Op::Fit: {
+                if (h.length % POINT_BYTES != 0) return answer(Status::BadRequest, nullptr, 0);
+                LineStats line;
+                for (uint32_t p = 0; p < h.length; p += POINT_BYTES) line.add(get_f64(payload + p), get_f64(payload + p + 8));
+                if (!line.solvable()) return answer(Status::Unsolvable, nullptr, 0);
+                auto [m, b] = line.solve();
+                uint8_t out[POINT_BYTES];
+                put_f64(out, m);
+                put_f64(out + 8, b);
+                return answer(Status::Ok, out, sizeof(out));
+            }
+            case Op::Load: {
+                if (h.length != POINT_BYTES) return answer(Status::BadRequest, nullptr, 0);
+                processor.load_weights(get_f64(payload), get_f64(payload + 8));
+                return answer(Status::Ok, nullptr, 0);
+            }
+            case Op::Process: {
+                if (h.length % 8 != 0) return answer(Status::BadRequest, nullptr, 0);
+                std::vector<uint8_t> out(h.length);
+                for (uint32_t p = 0; p < h.length; p += 8) put_f64(out.data() + p, processor.process(get_f64(payload + p)));
+                return answer(Status::Ok, out.data(), out.size());
+            }
+            case Op::Stats: {
+                uint8_t out[STATS_BYTES];
+                put_stats(out, stats.snapshot());
+                return answer(Status::Ok, out, sizeof(out));
+            }
+        }
+        answer(Status::BadRequest, nullptr, 0);
+    }
+
+    // false -    (    )
+    bool read_connection(const std::shared_ptr<Connection>& conn) {
+        using namespace DaemonProtocol;
+        uint8_t buf[65536];
+        while (true) {
+            ssize_t n = ::recv(conn->fd, buf, sizeof(buf), 0);
+            if (n == 0) return false;
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                return false;
+            }
+            conn->in.insert(conn->in.end(), buf, buf + n);
+        }
+
+        size_t pos = 0;
+        while (conn->in.size() - pos >= HEADER_BYTES) {
+            FrameHeader h = get_header(conn->in.data() + pos);
+            //     :    
+            if (h.magic != MAGIC || h.length > MAX_PAYLOAD) return false;
+            if (conn->in.size() - pos < HEADER_BYTES + h.length) break;
+            handle_frame(conn, h, conn->in.data() + pos + HEADER_BYTES);
+            pos += HEADER_BYTES + h.length;
+        }
+        conn->in.erase(conn->in.begin(), conn->in.begin() + static_cast<std::ptrdiff_t>(pos));
+        return true;
+    }
+
+    bool flush_connection(Connection& conn) {
+        std::lock_guard<std::mutex> lock(conn.out_mutex);
+        size_t sent = 0;
+        while (sent < conn.out.size()) {
+            ssize_t n = ::send(conn.fd, conn.out.data() + sent, conn.out.size() - sent, MSG_NOSIGNAL);
+            if (n < 0) {
+                if (errno == EINTR) continue;
+                if (errno == EAGAIN || errno == EWOULDBLOCK) break;
+                return false;
+            }
+            sent += static_cast<size_t>(n);
+        }
+        conn.out.erase(conn.out.begin(), conn.out.begin() + static_cast<std::ptrdiff_t>(sent));
+        return true;
+    }
+
+    void close_connection(Connection& conn) {
+        std::lock_guard<std::mutex> lock(conn.out_mutex);
+        conn.closed = true;
+        conn.out.clear();
+        ::close(conn.fd);
+        conn.fd = -1;
+    }
+
+    void report() {
+        DaemonProtocol::StatsReply s = stats.take_window();
+        std::cerr << std::fixed << std::setprecision(1)
+                  << "/: " << s.requests_per_sec
+                  << ",   /: " << (s.uptime > 0.0 ? static_cast<double>(s.queries) / s.uptime : 0.0)
+                  << ",  : " << s.mean_batch
+                  << ",  p50/p99: " << s.p50_us << "/" << s.p99_us << " "
+                  << ", : " << connections.size() << std::endl;
+    }
+
+public:
+    DaemonServer(const DaemonConfig& config, const QuantizedMlp* network) : config(config), network(network) {
+        if (::pipe2(wake_pipe, O_NONBLOCK | O_CLOEXEC) != 0) throw std::runtime_error("Cannot create wake pipe");
+
+        sockaddr_un addr = DaemonProtocol::make_address(config.socket_path);
+        listen_fd = ::socket(AF_UNIX, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        if (listen_fd < 0) throw std::runtime_error(std::string("Cannot create socket: ") + std::strerror(errno));
+        ::unlink(config.socket_path.c_str()); // ,    
+        if (::bind(listen_fd, reinterpret_cast<const sockaddr*>(&addr), sizeof(addr)) < 0 || ::listen(listen_fd, 128) < 0) {
+            throw std::runtime_error("Cannot listen on " + config.socket_path + ": " + std::strerror(errno));
+        }
+
+        if (network) batcher = std::make_unique<MicroBatcher>(*network, config, stats, [this] { wake(); });
+    }
+
+    ~DaemonServer() {
+        batcher.reset();
+        for (auto& conn : connections) close_connection(*conn);
+        if (listen_fd >= 0) {
+            ::close(listen_fd);
+            ::unlink(config.socket_path.c_str());
+        }
+        ::close(wake_pipe[0]);
+        ::close(wake_pipe[1]);
+    }
+
+    void run() {
+        auto next_report = Clock::now() + std::chrono::seconds(config.report_sec);
+        std::vector<pollfd> fds;
+        while (!g_stop) {
+            fds.clear();
+            fds.push_back({listen_fd, POLLIN, 0});
+            fds.push_back({wake_pipe[0], POLLIN, 0});
+            for (const auto& conn : connections) {
+                short events = POLLIN;
+                {
+                    std::lock_guard<std::mutex> lock(conn->out_mutex);
+                    if (!conn->out.empty()) events |= POLLOUT;
+                }
+                fds.push_back({conn->fd, events, 0});
+            }
+
+            int timeout_ms = -1;
+            if (config.report_sec > 0) {
+                auto wait = std::chrono::duration_cast<std::chrono::milliseconds>(next_report - Clock::now());
+                timeout_ms = static_cast<int>(std::max<long long>(0, wait.count()));
+            }
+            if (::poll(fds.data(), fds.size(), timeout_ms) < 0 && errno != EINTR) {
+                throw std::runtime_error(std::string("poll failed: ") + std::strerror(errno));
+            }
+
+            if (fds[1].revents & POLLIN) {
+                uint8_t drain[256];
+                while (::read(wake_pipe[0], drain, sizeof(drain)) > 0) {}
+            }
+
+            // ,    ,    fds    
+            size_t polled = fds.size() - 2;
+            for (size_t i = 0; i < polled; ++i) {
+                auto& conn = connections[i];
+                short revents = fds[i + 2].revents;
+                bool alive = !(revents & (POLLERR | POLLNVAL));
+                if (alive && (revents & (POLLIN | POLLHUP))) alive = read_connection(conn);
+                //     ,   -   
+                if (alive) alive = flush_connection(*conn);
+                if (!alive) close_connection(*conn);
+            }
+            connections.erase(std::remove_if(connections.begin(), connections.end(),
+                                             [](const std::shared_ptr<Connection>& c) { return c->fd < 0; }),
+                              connections.end());
+            if (fds[0].revents & POLLIN) accept_connections();
+            if (batcher) batcher->set_connections(connections.size());
+
+            if (config.report_sec > 0 && Clock::now() >= next_report) {
+                report();
+                next_report = Clock::now() + std::chrono::seconds(config.report_sec);
+            }
+        }
+
+        DaemonProtocol::StatsReply s = stats.snapshot();
+        std::cerr << std::fixed << std::setprecision(1)
+                  << ":  " << s.requests << ",    " << s.queries
+                  << ",  " << s.batches << " ( " << s.mean_batch << ")"
+                  << ",  p50/p99: " << s.p50_us << "/" << s.p99_us << " " << std::endl;
+    }
+};
+
+int main(int argc, char* argv[]) {
+    try {
+        DaemonConfig config = parse_args(argc, argv);
+
+        QuantizedMlp network;
+        if (!config.no_model) {
+            network.load(config.weights_file);
+            network.set_scale_mode(config.scale_mode);
+        }
+
+        std::signal(SIGINT, on_signal);
+        std::signal(SIGTERM, on_signal);
+
+        DaemonServer server(config, config.no_model ? nullptr : &network);
+        std::cerr << " : " << config.socket_path
+                  << ",   " << config.budget.count() << " "
+                  << ",   " << config.max_batch << " "
+                  << (config.no_model ? ",  " : "") << std::endl;
+        server.run();
+    } catch (const std::exception& e) {
+        std::cerr << " : " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -13,6 +13,8 @@
 
 #include <SDL2/SDL.h>
 
+#include "LinearApproximatorHDL.h" // Модель аппроксиматора с фиксированной точкой
+
 // --- Структуры для обмена данными между потоками ---
 std::mutex g_data_mutex; // Глобальный мьютекс для защиты данных
 std::vector<std::pair<double, double>> g_points; // Общий список точек
@@ -62,31 +64,6 @@ public:
         return true;
     }
 };
-constexpr int FIXED_POINT_BITS = 10; 
-constexpr long long SCALE = 1LL << FIXED_POINT_BITS;
-constexpr long long LEARNING_RATE_FIXED = static_cast<long long>(0.01 * SCALE);
-long long double_to_fixed(double val) { return static_cast<long long>(round(val * SCALE)); }
-double fixed_to_double(long long fixed_val) { return static_cast<double>(fixed_val) / SCALE; }
-class LinearApproximatorHDL {
-private:
-    long long m_fixed;
-    long long b_fixed;
-public:
-    LinearApproximatorHDL() : m_fixed(0), b_fixed(0) {}
-    void reset() { m_fixed = 0; b_fixed = 0; } // <-- НОВЫЙ МЕТОД для сброса
-    void update(long long x_fixed, long long y_fixed) {
-        long long product = m_fixed * x_fixed;
-        long long y_pred_fixed = (product >> FIXED_POINT_BITS) + b_fixed;
-        long long error_fixed = y_pred_fixed - y_fixed;
-        long long grad_m_fixed = (error_fixed * x_fixed) >> FIXED_POINT_BITS;
-        long long grad_b_fixed = error_fixed;
-        long long m_update = (LEARNING_RATE_FIXED * grad_m_fixed) >> FIXED_POINT_BITS;
-        long long b_update = (LEARNING_RATE_FIXED * grad_b_fixed) >> FIXED_POINT_BITS;
-        m_fixed -= m_update;
-        b_fixed -= b_update;
-    }
-    std::pair<double, double> getCoeffsDouble() const { return {fixed_to_double(m_fixed), fixed_to_double(b_fixed)}; }
-};
 
 
 void draw_point_on_vga(VgaSimulator& vga, int cx, int cy, uint32_t color) { for (int y = cy - 1; y <= cy + 1; ++y) for (int x = cx - 1; x <= cx + 1; ++x) vga.draw_pixel(x, y, color); }
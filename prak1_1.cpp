@@ -13,6 +13,10 @@
 
 #include <SDL2/SDL.h>
 
+#include "Journal.h"
+#include "EventTrace.h"
+#include "LineFitPipelines.h"
+
 // =============================================================================
 // КОНФИГУРАЦИЯ
 // =============================================================================
@@ -26,13 +30,14 @@ namespace Config {
 		constexpr uint32_t POINT_COLOR = 0xFF00A0FF;
 		constexpr uint32_t LINE_COLOR = 0xFFFF4040;
 
-		constexpr int FIXED_POINT_BITS = 10;
-		constexpr double LEARNING_RATE = 0.01;
-		constexpr int TRAINING_EPOCHS = 500;
+		// Разрядность, скорость обучения и число эпох - в Prak1Fit (LineFitPipelines.h)
 
 		constexpr double PADDING_FACTOR = 0.1;
 		constexpr double MIN_PADDING = 1.0;
 		constexpr int POINT_SIZE = 1;
+
+		constexpr const char* STATE_FILE = "prak1_1_state"; // prak1_1_state.journal и .snap
+		constexpr size_t SNAPSHOT_EVERY = 100;              // снимок каждые N новых точек
 }
 
 // =============================================================================
@@ -72,18 +77,9 @@ public:
 		};
 
 private:
-		static constexpr long long SCALE = 1LL << Config::FIXED_POINT_BITS;
 		long long slope_fixed = 0;
 		long long intercept_fixed = 0;
 
-		static long long to_fixed(double value) {
-				return static_cast<long long>(round(value * SCALE));
-		}
-
-		static double from_fixed(long long fixed_value) {
-				return static_cast<double>(fixed_value) / SCALE;
-		}
-
 public:
 		void reset() {
 				slope_fixed = 0;
@@ -92,30 +88,21 @@ public:
 
 		void train(const std::vector<Point>& points) {
 				if (points.empty()) return;
+				Prak1Fit::train(points, slope_fixed, intercept_fixed);
+		}
 
-				reset();
-
-				const long long learning_rate_fixed = to_fixed(Config::LEARNING_RATE);
-
-				for (int epoch = 0; epoch < Config::TRAINING_EPOCHS; ++epoch) {
-						for (const auto& point : points) {
-								long long x_fixed = to_fixed(point.x);
-								long long y_fixed = to_fixed(point.y);
-
-								long long y_pred_fixed = ((slope_fixed * x_fixed) >> Config::FIXED_POINT_BITS) + intercept_fixed;
-								long long error_fixed = y_pred_fixed - y_fixed;
-
-								long long grad_slope = (error_fixed * x_fixed) >> Config::FIXED_POINT_BITS;
-								long long grad_intercept = error_fixed;
+		Coefficients get_coefficients() const {
+				return {Prak1Fit::from_fixed(slope_fixed), Prak1Fit::from_fixed(intercept_fixed)};
+		}
 
-								slope_fixed -= (learning_rate_fixed * grad_slope) >> Config::FIXED_POINT_BITS;
-								intercept_fixed -= (learning_rate_fixed * grad_intercept) >> Config::FIXED_POINT_BITS;
-						}
-				}
+		// Регистры как есть - для снимка состояния
+		std::pair<long long, long long> get_fixed() const {
+				return {slope_fixed, intercept_fixed};
 		}
 
-		Coefficients get_coefficients() const {
-				return {from_fixed(slope_fixed), from_fixed(intercept_fixed)};
+		void set_fixed(long long slope, long long intercept) {
+				slope_fixed = slope;
+				intercept_fixed = intercept;
 		}
 };
 
@@ -311,14 +298,77 @@ private:
 		std::mutex points_mutex;
 		bool running = true;
 
+		StateJournal journal{Config::STATE_FILE};
+		size_t points_since_snapshot = 0;
+
+		// Вызывается под points_mutex
+		Snapshot make_snapshot() const {
+				std::vector<JournalPoint> saved;
+				saved.reserve(points.size());
+				for (const auto& point : points) {
+						saved.push_back({point.x, point.y});
+				}
+				auto [slope, intercept] = regression.get_fixed();
+				const long long registers[2] = {slope, intercept};
+
+				Snapshot snapshot;
+				snapshot.add(SnapshotTag::Points, saved);
+				snapshot.add(SnapshotTag::HdlCoeffs, registers, 2);
+				return snapshot;
+		}
+
+		// Точки из снимка и хвоста журнала. Регистры берутся из снимка; обучение
+		// заново нужно, только если после снимка были новые точки.
+		void restore_state() {
+				auto recovery = journal.recover();
+				if (recovery.lost > 0) {
+						std::printf("Внимание: журнал неполон (снимок старше журнала или сбой записи), потеряно точек: %llu\n",
+												static_cast<unsigned long long>(recovery.lost));
+				}
+				std::lock_guard<std::mutex> lock(points_mutex);
+				for (const auto& p : recovery.snapshot.get<JournalPoint>(SnapshotTag::Points)) {
+						points.push_back(Point(p.x, p.y));
+				}
+				for (const auto& p : recovery.tail) {
+						points.push_back(Point(p.x, p.y));
+				}
+				for (const auto& point : points) {
+						trace_event(TraceEvent::Restored, point.x, point.y);
+				}
+				if (points.empty()) return;
+
+				auto registers = recovery.snapshot.get<long long>(SnapshotTag::HdlCoeffs);
+				if (recovery.tail.empty() && registers.size() == 2) {
+						regression.set_fixed(registers[0], registers[1]);
+				} else {
+						regression.train(points);
+				}
+				points_since_snapshot = recovery.tail.size();
+
+				auto coeffs = regression.get_coefficients();
+				std::printf("Восстановлено точек: %zu (из журнала: %zu) за %.2f мс\n",
+										points.size(), recovery.tail.size(), recovery.milliseconds);
+				std::printf("Уравнение: y = %.4fx + %.4f\n\n", coeffs.slope, coeffs.intercept);
+		}
+
 		void add_point(const Point& point) {
+				LinearRegression::Coefficients coeffs;
 				{
 						std::lock_guard<std::mutex> lock(points_mutex);
+						trace_event(TraceEvent::Handoff, point.x, point.y);
 						points.push_back(point);
+						trace_event(TraceEvent::TrainBegin, static_cast<double>(points.size()));
 						regression.train(points);
+						coeffs = regression.get_coefficients();
+						trace_event(TraceEvent::TrainEnd, coeffs.slope, coeffs.intercept);
+						journal.append(point.x, point.y);
+						if (++points_since_snapshot >= Config::SNAPSHOT_EVERY) {
+								journal.checkpoint(make_snapshot());
+								points_since_snapshot = 0;
+						}
 				}
 
-				auto coeffs = regression.get_coefficients();
+				// Печать - уже без блокировки, чтобы не задерживать отрисовку
 				std::printf("Добавлена точка (%.2f, %.2f)\n", point.x, point.y);
 				std::printf("Уравнение: y = %.4fx + %.4f\n\n", coeffs.slope, coeffs.intercept);
 		}
@@ -345,6 +395,7 @@ private:
 
 								try {
 										Point point = Point::parse(line);
+										trace_event(TraceEvent::Input, point.x, point.y);
 										add_point(point);
 								} catch (const std::exception& e) {
 										std::cerr << "Ошибка: " << e.what() << std::endl;
@@ -355,9 +406,11 @@ private:
 
 public:
 		void run() {
+				restore_state();
 				start_input_thread();
 
 				const auto frame_duration = std::chrono::milliseconds(1000 / Config::TARGET_FPS);
+				std::string journal_error; // последняя показанная ошибка записи журнала
 
 				while (running) {
 						auto frame_start = std::chrono::steady_clock::now();
@@ -367,9 +420,22 @@ public:
 								break;
 						}
 
+						// Сбой записи журнала виден сразу, а не только при выходе: точки пока в памяти
+						std::string error = journal.last_error();
+						if (error != journal_error) {
+								if (!error.empty()) {
+										std::fprintf(stderr, "Внимание: журнал не записывается (%s), новые точки пока только в памяти.\n", error.c_str());
+								} else {
+										std::printf("Запись журнала восстановлена.\n");
+								}
+								journal_error = error;
+						}
+
 						{
 								std::lock_guard<std::mutex> lock(points_mutex);
+								trace_event(TraceEvent::RenderBegin, static_cast<double>(points.size()));
 								graphics.render_scene(points, regression);
+								trace_event(TraceEvent::RenderEnd);
 						}
 
 						auto frame_end = std::chrono::steady_clock::now();
@@ -378,6 +444,14 @@ public:
 								std::this_thread::sleep_for(frame_duration - elapsed);
 						}
 				}
+
+				{
+						std::lock_guard<std::mutex> lock(points_mutex);
+						if (points_since_snapshot > 0) {
+								journal.checkpoint(make_snapshot());
+						}
+				}
+				journal.flush();
 		}
 };
 
@@ -386,6 +460,7 @@ public:
 // =============================================================================
 int main() {
 		try {
+				TraceSession trace("prak1_1"); // NEIRO_TRACE=<файл> - писать трассу событий (EventTrace.h)
 				Application app;
 				app.run();
 		} catch (const std::exception& e) {
@@ -0,0 +1,93 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <stdexcept>
+#include <cmath>
+
+#include "RobustFit.h"
+
+//   :     ,   
+// (      ).  , RANSAC  
+//      .
+
+struct BenchConfig {
+    size_t points = 1000000;
+    double outliers = 0.2;   //  
+    size_t threads = 0;      // 0 -  
+    RobustOptions options;
+};
+
+static BenchConfig parse_args(int argc, char* argv[]) {
+    BenchConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--points") config.points = std::stoul(next());
+        else if (arg == "--outliers") config.outliers = std::stod(next());
+        else if (arg == "--threads") config.threads = std::stoul(next());
+        else if (arg == "--hypotheses") config.options.hypotheses = std::stoul(next());
+        else if (arg == "--threshold") config.options.threshold = std::stod(next());
+        else throw std::runtime_error("Usage: robust_bench [--points N] [--outliers F] [--threads N] [--hypotheses N] [--threshold T]");
+    }
+    if (config.points < 2 || config.outliers < 0.0 || config.outliers >= 1.0) {
+        throw std::runtime_error("Need at least 2 points and outlier fraction in [0, 1)");
+    }
+    return config;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        BenchConfig config = parse_args(argc, argv);
+        ThreadPool pool(config.threads > 0 ? config.threads : std::max(1u, std::thread::hardware_concurrency()));
+        RobustRegressor regressor(&pool);
+
+        const double true_m = 2.5, true_b = -1.0;
+        std::mt19937_64 gen(42);
+        std::uniform_real_distribution<> x_dist(-10.0, 10.0), outlier_dist(-100.0, 100.0), unit(0.0, 1.0);
+        std::normal_distribution<> noise(0.0, 0.1);
+        regressor.reserve(config.points);
+        for (size_t i = 0; i < config.points; ++i) {
+            double x = x_dist(gen);
+            double y = unit(gen) < config.outliers ? outlier_dist(gen) : true_m * x + true_b + noise(gen);
+            regressor.add(x, y);
+        }
+
+        std::cout << ": " << config.points << ", : " << config.outliers * 100.0 << "%, : "
+                  << pool.size() << ", : " << config.options.hypotheses << std::endl;
+        std::cout << std::fixed;
+
+        auto report = [&](const char* name, const RobustResult& r, double seconds) {
+            std::cout << std::setw(8) << name << ": " << std::setprecision(1) << seconds * 1000.0 << " , m = "
+                      << std::setprecision(4) << r.m << ", b = " << r.b << ",  = "
+                      << std::max(std::abs(r.m - true_m), std::abs(r.b - true_b)) << ", : " << r.inliers;
+            if (r.iterations > 0) std::cout << ", : " << r.iterations;
+            std::cout << std::endl;
+        };
+
+        auto start = std::chrono::steady_clock::now();
+        RobustResult ols = regressor.fit_ols();
+        report("", ols, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+        start = std::chrono::steady_clock::now();
+        RobustResult ransac = regressor.fit_ransac(config.options);
+        report("RANSAC", ransac, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+        start = std::chrono::steady_clock::now();
+        RobustResult huber = regressor.fit_huber(config.options);
+        report("", huber, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+
+        start = std::chrono::steady_clock::now();
+        RobustResult refined = regressor.fit_huber(config.options, &ransac);
+        report("R+", refined, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    } catch (const std::exception& e) {
+        std::cerr << " : " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
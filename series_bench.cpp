@@ -0,0 +1,137 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <thread>
+#include <random>
+#include <chrono>
+#include <stdexcept>
+#include <cmath>
+#include <algorithm>
+
+#include "SeriesEngine.h"
+
+//   SeriesEngine:  ,    .
+//  -   ,    
+//       .
+
+struct BenchConfig {
+    size_t series = 100000;
+    size_t updates = 20000000;
+    size_t batch = 4096;
+    size_t producers = 1;
+    SeriesEngine::Options engine;
+};
+
+static BenchConfig parse_args(int argc, char* argv[]) {
+    BenchConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--series") config.series = std::stoul(next());
+        else if (arg == "--updates") config.updates = std::stoul(next());
+        else if (arg == "--batch") config.batch = std::stoul(next());
+        else if (arg == "--producers") config.producers = std::stoul(next());
+        else if (arg == "--shards") config.engine.shards = std::stoul(next());
+        else throw std::runtime_error("Unknown argument: " + arg);
+    }
+    if (config.series == 0 || config.batch == 0 || config.producers == 0) {
+        throw std::runtime_error("Usage: series_bench [--series N] [--updates N] [--batch N] [--producers N] [--shards N]");
+    }
+    config.engine.expected_series = config.series;
+    return config;
+}
+
+//    -    
+static std::pair<double, double> true_line(SeriesId id) {
+    uint64_t h = SeriesTable::hash_slot(id);
+    double m = static_cast<double>(h & 0xFFFF) / 65535.0 * 10.0 - 5.0;
+    double b = static_cast<double>((h >> 16) & 0xFFFF) / 65535.0 * 10.0 - 5.0;
+    return {m, b};
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        BenchConfig config = parse_args(argc, argv);
+        SeriesEngine engine(config.engine);
+
+        //   ,      
+        size_t per_producer = config.updates / config.producers;
+        size_t pool_size = std::min<size_t>(per_producer, 1 << 20);
+        std::vector<std::vector<SeriesUpdate>> sources(config.producers);
+        for (size_t p = 0; p < config.producers; ++p) {
+            std::mt19937_64 gen(100 + p);
+            std::uniform_int_distribution<SeriesId> id_dist(0, config.series - 1);
+            std::uniform_real_distribution<> x_dist(-10.0, 10.0), noise(-0.01, 0.01);
+            sources[p].resize(pool_size);
+            for (auto& u : sources[p]) {
+                u.id = id_dist(gen);
+                u.x = x_dist(gen);
+                auto [m, b] = true_line(u.id);
+                u.y = m * u.x + b + noise(gen);
+            }
+        }
+
+        std::cout << ": " << config.series << ", : " << engine.shard_count()
+                  << ", : " << config.producers << ", : " << config.batch << std::endl;
+
+        auto start = std::chrono::steady_clock::now();
+        std::vector<std::thread> producers;
+        for (size_t p = 0; p < config.producers; ++p) {
+            producers.emplace_back([&, p] {
+                const auto& source = sources[p];
+                size_t sent = 0, pos = 0;
+                while (sent < per_producer) {
+                    size_t n = std::min({config.batch, per_producer - sent, source.size() - pos});
+                    engine.update_batch(source.data() + pos, n);
+                    sent += n;
+                    pos = (pos + n) % source.size();
+                }
+            });
+        }
+        for (auto& t : producers) t.join();
+        engine.flush();
+        double update_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::vector<SeriesId> ids(config.series);
+        for (size_t i = 0; i < ids.size(); ++i) ids[i] = i;
+        std::vector<SeriesCoeffs> coeffs(ids.size());
+        start = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < ids.size(); i += config.batch) {
+            size_t n = std::min(config.batch, ids.size() - i);
+            engine.query_batch(ids.data() + i, n, coeffs.data() + i);
+        }
+        double query_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        double max_err = 0.0, rmse_sum = 0.0, r2_sum = 0.0;
+        size_t fitted = 0;
+        for (size_t i = 0; i < ids.size(); ++i) {
+            if (!coeffs[i].valid) continue;
+            ++fitted;
+            auto [m, b] = true_line(ids[i]);
+            max_err = std::max({max_err, std::abs(coeffs[i].m - m), std::abs(coeffs[i].b - b)});
+            rmse_sum += coeffs[i].rmse;
+            r2_sum += coeffs[i].r2;
+        }
+
+        auto stats = engine.get_stats();
+        std::cout << std::fixed << std::setprecision(2);
+        std::cout << ": " << stats.updates << "  " << update_seconds << "  ("
+                  << stats.updates / update_seconds / 1e6 << " /)" << std::endl;
+        std::cout << ": " << ids.size() << "  " << std::setprecision(3) << query_seconds << "  ("
+                  << std::setprecision(2) << ids.size() / query_seconds / 1e6 << " /)" << std::endl;
+        std::cout << "  : " << fitted << "  " << stats.series
+                  << ", .  : " << std::setprecision(5) << max_err << std::endl;
+        if (fitted > 0) {
+            std::cout << "  : RMSE = " << rmse_sum / fitted
+                      << ", R^2 = " << std::setprecision(6) << r2_sum / fitted << std::endl;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << " : " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,147 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <chrono>
+#include <functional>
+#include <stdexcept>
+
+#include "QuantizedMlp.h"
+#include "StaticMlp.h"
+
+//   ,    (weights_tool header network_weights.nwb network_weights.h).
+//     QuantizedMlp  StaticMlp  ,   .
+#if __has_include("network_weights.h")
+#include "network_weights.h"
+#define HAVE_EMBEDDED_WEIGHTS 1
+#endif
+
+//     6 -> 32 -> 16 -> 2: QuantizedMlp (  
+//  )  StaticMlp<6, 32, 16, 2>       ,
+//   . ,        
+//   SCALE,         .
+
+using Network = StaticMlp<6, 32, 16, 2>;
+
+struct BenchConfig {
+    std::string weights_file = "network_weights.nwb";
+    size_t samples = 200000;
+    int rounds = 5;
+};
+
+static BenchConfig parse_args(int argc, char* argv[]) {
+    BenchConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--weights") config.weights_file = next();
+        else if (arg == "--samples") config.samples = std::stoul(next());
+        else if (arg == "--rounds") config.rounds = std::stoi(next());
+        else throw std::runtime_error("Usage: static_mlp_bench [--weights network_weights.nwb] [--samples N] [--rounds R]");
+    }
+    if (config.samples == 0 || config.rounds <= 0) throw std::runtime_error("Invalid arguments");
+    return config;
+}
+
+//   rounds     ,   
+static double time_ns(const BenchConfig& config, const std::vector<int32_t>& coords, std::vector<int32_t>& out,
+                      const std::function<void(const int32_t*, int32_t*)>& infer_one) {
+    double best = 0.0;
+    for (int r = 0; r < config.rounds; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t s = 0; s < config.samples; ++s) infer_one(&coords[s * 6], &out[s * 2]);
+        double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / config.samples;
+        if (r == 0 || ns < best) best = ns;
+    }
+    return best;
+}
+
+static size_t count_mismatches(const std::vector<int32_t>& a, const std::vector<int32_t>& b) {
+    size_t mismatches = 0;
+    for (size_t i = 0; i < a.size(); ++i) {
+        if (a[i] != b[i]) ++mismatches;
+    }
+    return mismatches;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        BenchConfig config = parse_args(argc, argv);
+        QuantizedMlp network;
+        network.load(config.weights_file);
+        Network loaded = Network::from(network);
+
+        //          
+        BundleRanges r = network.export_ranges();
+        double x_pad = (r.x_max - r.x_min) / 4.0, y_pad = (r.y_max - r.y_min) / 4.0;
+        std::mt19937 gen(5);
+        std::uniform_real_distribution<> x_dist(r.x_min - x_pad, r.x_max + x_pad), y_dist(r.y_min - y_pad, r.y_max + y_pad);
+        std::vector<int32_t> coords(config.samples * 6);
+        for (size_t i = 0; i < coords.size(); i += 2) {
+            coords[i] = network.to_fixed(x_dist(gen));
+            coords[i + 1] = network.to_fixed(y_dist(gen));
+        }
+
+        std::vector<int32_t> reference(config.samples * 2), out(config.samples * 2);
+        std::vector<int32_t> a(network.max_width()), z(network.max_width());
+        size_t mismatches = 0;
+
+        double dense_ns = time_ns(config, coords, reference, [&](const int32_t* c, int32_t* o) { network.infer(c, o, a.data(), z.data()); });
+        double loaded_ns = time_ns(config, coords, out, [&](const int32_t* c, int32_t* o) { loaded.infer(c, o); });
+        size_t loaded_mismatches = count_mismatches(reference, out);
+        mismatches += loaded_mismatches;
+
+        std::cout << " " << config.weights_file << ", " << config.samples << " ,   " << config.rounds << ":" << std::endl;
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "  QuantizedMlp:                 " << std::setw(8) << dense_ns << " /" << std::endl;
+        std::cout << "  StaticMlp,   :     " << std::setw(8) << loaded_ns << " / (x" << std::setprecision(2)
+                  << dense_ns / loaded_ns << "), : " << loaded_mismatches << std::endl;
+        std::cout << std::setprecision(1);
+
+#ifdef HAVE_EMBEDDED_WEIGHTS
+        static_assert(std::is_same<network_weights::Network, Network>::value, "network_weights.h has a different topology");
+        const Network& embedded = network_weights::NETWORK;
+        bool same_weights = embedded.params == loaded.params;
+        double embedded_ns = time_ns(config, coords, out, [&](const int32_t* c, int32_t* o) { network_weights::NETWORK.infer(c, o); });
+        //   --pipelined-rtl   QuantizedMlp     
+        std::vector<int32_t> embedded_reference = reference;
+        if (embedded.scale_mode != network.get_scale_mode()) {
+            network.set_scale_mode(embedded.scale_mode);
+            for (size_t s = 0; s < config.samples; ++s) network.infer(&coords[s * 6], &embedded_reference[s * 2], a.data(), z.data());
+            network.set_scale_mode(QuantizedMlp::ScaleMode::Divide);
+        }
+        size_t embedded_mismatches = count_mismatches(embedded_reference, out);
+        std::cout << "  StaticMlp,   :       " << std::setw(8) << embedded_ns << " / (x" << std::setprecision(2)
+                  << dense_ns / embedded_ns << "), : " << embedded_mismatches
+                  << (embedded.scale_mode == QuantizedMlp::ScaleMode::InvScaleShift ? " ( )" : "") << std::endl;
+        std::cout << std::setprecision(1);
+        //         -    
+        if (same_weights) mismatches += embedded_mismatches;
+        else std::cout << "  network_weights.h    ,  " << config.weights_file << std::endl;
+#else
+        std::cout << "  network_weights.h : weights_tool header " << config.weights_file << " network_weights.h" << std::endl;
+#endif
+
+        //  ,     RTL
+        network.set_scale_mode(QuantizedMlp::ScaleMode::InvScaleShift);
+        loaded = Network::from(network);
+        for (size_t s = 0; s < config.samples; ++s) {
+            network.infer(&coords[s * 6], &reference[s * 2], a.data(), z.data());
+            loaded.infer(&coords[s * 6], &out[s * 2]);
+        }
+        size_t shift_mismatches = count_mismatches(reference, out);
+        mismatches += shift_mismatches;
+        std::cout << "    (INV_SCALE), : " << shift_mismatches << std::endl;
+        std::cout.unsetf(std::ios::fixed);
+
+        if (mismatches > 0) return 2;
+    } catch (const std::exception& e) {
+        std::cerr << " : " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,257 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <chrono>
+#include <algorithm>
+#include <functional>
+#include <stdexcept>
+#include <cstdint>
+#include <cmath>
+
+#include <time.h>
+
+#include "BatchGenerator.h"
+#include "ThreadPool.h"
+#include "MlpTraining.h"
+
+//   generate_weights:    ,
+//  , seed    seed  . 
+//      (ThreadPool.h),    ,
+//        ,  
+//     m  b   (  ).
+//
+//     ,    ,     
+//  ,       . 
+//    :  Philox -    (seed, ), 
+//   lr 0.001,  128, seed 1   1337 
+// generate_weights .       .
+
+struct SweepConfig {
+    int steps = 80000;
+    std::vector<double> learning_rates = {0.0005, 0.001, 0.002, 0.004};
+    std::vector<size_t> batch_sizes = {64, 128};
+    std::vector<unsigned int> init_seeds = {1, 7, 13, 19};
+    std::vector<uint64_t> data_seeds = {1337, 2024};
+    size_t threads = std::thread::hardware_concurrency();
+    bool pin = true;
+    Precision precision = Precision::Double;
+    size_t top = 10;
+    bool save = false;  //     network_weights.txt/.nwb
+};
+
+template<typename V>
+static std::vector<V> parse_list(const std::string& text, const std::function<V(const std::string&)>& convert) {
+    std::vector<V> values;
+    std::stringstream ss(text);
+    std::string item;
+    while (std::getline(ss, item, ',')) {
+        if (!item.empty()) values.push_back(convert(item));
+    }
+    if (values.empty()) throw std::runtime_error("Empty list: " + text);
+    return values;
+}
+
+static SweepConfig parse_args(int argc, char* argv[]) {
+    SweepConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--steps") config.steps = std::stoi(next());
+        else if (arg == "--lr") config.learning_rates = parse_list<double>(next(), [](const std::string& s) { return std::stod(s); });
+        else if (arg == "--batch") config.batch_sizes = parse_list<size_t>(next(), [](const std::string& s) { return std::stoul(s); });
+        else if (arg == "--init-seeds") config.init_seeds = parse_list<unsigned int>(next(), [](const std::string& s) { return static_cast<unsigned int>(std::stoul(s)); });
+        else if (arg == "--data-seeds") config.data_seeds = parse_list<uint64_t>(next(), [](const std::string& s) { return std::stoull(s); });
+        else if (arg == "--threads") config.threads = std::stoul(next());
+        else if (arg == "--no-pin") config.pin = false;
+        else if (arg == "--top") config.top = std::stoul(next());
+        else if (arg == "--save") config.save = true;
+        else if (arg == "--precision") {
+            std::string p = next();
+            if (p == "double") config.precision = Precision::Double;
+            else if (p == "float") config.precision = Precision::Float;
+            else if (p == "mixed") config.precision = Precision::Mixed;
+            else throw std::runtime_error("Precision must be double, float or mixed");
+        }
+        else throw std::runtime_error("Usage: sweep_weights [--steps N] [--lr A,B,..] [--batch A,B,..] [--init-seeds A,B,..] "
+                                      "[--data-seeds A,B,..] [--threads T] [--no-pin] [--top K] [--save] "
+                                      "[--precision double|float|mixed]");
+    }
+    if (config.steps <= 0) throw std::runtime_error("Invalid arguments");
+    for (size_t b : config.batch_sizes) {
+        if (b == 0) throw std::runtime_error("Batch size must be positive");
+    }
+    return config;
+}
+
+struct SweepJob {
+    double learning_rate;
+    size_t batch;
+    unsigned int init_seed;
+    uint64_t data_seed;
+};
+
+struct SweepResult {
+    SweepJob job{};
+    double loss = 0.0;       //       
+    Accuracy accuracy;
+    bool diverged = false;
+    double seconds = 0.0;    //   :     
+    std::vector<BundleLayerData> quantized;
+
+    double score() const { return diverged ? INFINITY : accuracy.q_m + accuracy.q_b; }
+};
+
+//  :   ,  
+// ;       
+template<typename T,typename Acc> struct TrainerSlot {
+    Network<T> net = make_network<T>();
+    size_t batch = 0;
+    std::unique_ptr<Workspace<T,Acc>> workspace;
+    Matrix<T> X, Y;
+
+    void reserve(size_t batch_size) {
+        if (batch_size == batch) return;
+        batch = batch_size;
+        workspace = std::make_unique<Workspace<T,Acc>>(batch_size);
+        X = Matrix<T>(batch_size, INPUT_SIZE);
+        Y = Matrix<T>(batch_size, OUTPUT_SIZE);
+    }
+};
+
+const LineBatchRanges LINE_RANGES{M_B_MIN, M_B_MAX, X_MIN, X_MAX, Y_MIN, Y_MAX};
+
+//           seed,
+//        
+const uint64_t EVAL_SEED = 0x5EEDE7A1;
+const size_t EVAL_SIZE = 8192;
+const int LOSS_WINDOW = 1000;
+
+static double thread_cpu_seconds() {
+    timespec ts{};
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return static_cast<double>(ts.tv_sec) + static_cast<double>(ts.tv_nsec) * 1e-9;
+}
+
+template<typename T,typename Acc> SweepResult train_job(TrainerSlot<T,Acc>& slot, const SweepJob& job, int steps, const EvalSet& eval) {
+    double start = thread_cpu_seconds();
+    SweepResult result;
+    result.job = job;
+
+    slot.reserve(job.batch);
+    init_network(slot.net, job.init_seed);
+    PhiloxLineGenerator generator(job.data_seed, LINE_RANGES);
+    const PruneMasks<T> no_masks;
+
+    int window = std::min(steps, LOSS_WINDOW);
+    double window_loss = 0.0;
+    for (int step = 0; step < steps; ++step) {
+        generator.generate(static_cast<uint64_t>(step), 0, job.batch, slot.X.d.data(), slot.Y.d.data());
+        double loss = train_step(slot.net, slot.X, slot.Y, job.learning_rate, no_masks, *slot.workspace);
+        if (!std::isfinite(loss)) {
+            result.diverged = true;
+            break;
+        }
+        if (step >= steps - window) window_loss += loss / static_cast<double>(job.batch);
+    }
+
+    if (!result.diverged) {
+        result.loss = window_loss / window;
+        result.accuracy = evaluate<T,Acc>(slot.net, eval);
+        result.quantized = quantize_network(slot.net);
+    }
+    result.seconds = thread_cpu_seconds() - start;
+    return result;
+}
+
+static void print_row(std::ostream& out, const SweepResult& r) {
+    out << std::setw(9) << r.job.learning_rate << std::setw(6) << r.job.batch << std::setw(6) << r.job.init_seed
+        << std::setw(7) << r.job.data_seed << std::fixed << std::setprecision(5);
+    if (r.diverged) {
+        out << "   ";
+    } else {
+        out << std::setw(10) << r.loss << std::setprecision(4) << std::setw(9) << r.accuracy.m << std::setw(9) << r.accuracy.b
+            << std::setw(9) << r.accuracy.q_m << std::setw(9) << r.accuracy.q_b;
+    }
+    out << std::setprecision(1) << std::setw(7) << r.seconds << " " << std::endl;
+    out.unsetf(std::ios::fixed);
+    out << std::setprecision(6);
+}
+
+static const char* TABLE_HEADER = "       lr    seed             m        b  .m  .b  ";
+
+template<typename T,typename Acc> int run(const SweepConfig& config) {
+    std::vector<SweepJob> jobs;
+    for (double lr : config.learning_rates)
+        for (size_t batch : config.batch_sizes)
+            for (unsigned int init_seed : config.init_seeds)
+                for (uint64_t data_seed : config.data_seeds) jobs.push_back({lr, batch, init_seed, data_seed});
+    //    ( ):    ,   
+    //   
+    std::stable_sort(jobs.begin(), jobs.end(), [](const SweepJob& a, const SweepJob& b) { return a.batch > b.batch; });
+
+    EvalSet eval{Matrix<double>(EVAL_SIZE,INPUT_SIZE), Matrix<double>(EVAL_SIZE,OUTPUT_SIZE)};
+    PhiloxLineGenerator(EVAL_SEED, LINE_RANGES).generate(0, 0, EVAL_SIZE, eval.X.d.data(), eval.Y.d.data());
+
+    ThreadPool pool(std::max<size_t>(1, std::min(config.threads, jobs.size())));
+    bool pinned = config.pin && pool.pin_to_cores();
+    std::cout << " " << jobs.size() << "   " << config.steps << " , : " << pool.size()
+              << (pinned ? " (  )" : "") << std::endl;
+
+    std::vector<SweepResult> results(jobs.size());
+    std::mutex print_mutex;
+    size_t finished = 0;
+    auto start = std::chrono::steady_clock::now();
+    pool.run(jobs.size(), [&](size_t i) {
+        static thread_local TrainerSlot<T,Acc> slot;
+        results[i] = train_job(slot, jobs[i], config.steps, eval);
+        std::lock_guard<std::mutex> lock(print_mutex);
+        std::cout << "[" << std::setw(3) << ++finished << "/" << jobs.size() << "]";
+        print_row(std::cout, results[i]);
+    });
+    double wall = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    std::stable_sort(results.begin(), results.end(), [](const SweepResult& a, const SweepResult& b) { return a.score() < b.score(); });
+    double serial = 0.0;
+    for (const auto& r : results) serial += r.seconds;
+
+    std::cout << std::endl << "  ( m, b -    " << EVAL_SIZE
+              << "   ;  -    " << std::min(config.steps, LOSS_WINDOW) << " ):" << std::endl;
+    std::cout << "" << TABLE_HEADER << std::endl;
+    for (size_t i = 0; i < std::min(config.top, results.size()); ++i) {
+        std::cout << std::setw(5) << i + 1;
+        print_row(std::cout, results[i]);
+    }
+    std::cout << std::fixed << std::setprecision(2) << " : " << wall << " ,   : " << serial
+              << "  ( " << serial / wall << "x)" << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+
+    const SweepResult& best = results.front();
+    if (best.diverged) throw std::runtime_error("All configurations diverged");
+    if (config.save) {
+        save_weights(best.quantized);
+        std::cout << "     network_weights.txt  network_weights.nwb" << std::endl;
+    }
+    return 0;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        SweepConfig config = parse_args(argc, argv);
+        switch (config.precision) {
+        case Precision::Float: return run<float, float>(config);
+        case Precision::Mixed: return run<float, double>(config);
+        default: return run<double, double>(config);
+        }
+    } catch (const std::exception& e) {
+        std::cerr << " : " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,473 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <deque>
+#include <optional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
+#include <stdexcept>
+#include <cstdint>
+#include <cstring>
+#include <cmath>
+
+#include "EventTrace.h"
+#include "LineFitPipelines.h"
+
+//      (EventTrace.h),  main2  prak1_1
+//  NEIRO_TRACE=<>.
+//
+//   dump   -   ;
+//   stats  -    :   , ,
+//                 ;    ; 
+//                 ;
+//   replay -    (  )     :
+//             ,  ,    ,  .
+//             :  -     ,   .
+//            --speed 1 -    (K -  K  ), max -  .
+//                   .
+//
+//          ( --pipeline):
+// main2 -      ,    
+//    ( g_new_point); prak1_1 -    
+//         .
+
+struct ReplayConfig {
+    std::string command;
+    std::string trace_file;
+    std::string pipeline;       //  -   
+    double speed = 1.0;         // 0 -  
+    double frame_ms = -1.0;     //   ; <0 - 16    ,    max
+    std::string trace_out;      //   
+    size_t top = 10;
+};
+
+static ReplayConfig parse_args(int argc, char* argv[]) {
+    ReplayConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--speed") {
+            std::string v = next();
+            config.speed = v == "max" ? 0.0 : std::stod(v);
+            if (config.speed < 0.0) throw std::runtime_error("Speed must be positive or 'max'");
+        }
+        else if (arg == "--pipeline") config.pipeline = next();
+        else if (arg == "--frame-ms") config.frame_ms = std::stod(next());
+        else if (arg == "--trace-out") config.trace_out = next();
+        else if (arg == "--top") config.top = std::stoul(next());
+        else if (config.command.empty()) config.command = arg;
+        else if (config.trace_file.empty()) config.trace_file = arg;
+        else throw std::runtime_error("Unknown argument: " + arg);
+    }
+    if ((config.command != "dump" && config.command != "stats" && config.command != "replay") || config.trace_file.empty()) {
+        throw std::runtime_error("Usage: trace_replay <dump|stats|replay> <trace> [--speed K|max] [--pipeline main2|prak1_1] "
+                                 "[--frame-ms N] [--trace-out FILE] [--top N]");
+    }
+    return config;
+}
+
+static double to_ms(uint64_t ns) { return static_cast<double>(ns) / 1e6; }
+
+//     ( - ,     )
+struct Summary {
+    size_t count = 0;
+    double p50 = 0.0, p99 = 0.0, max = 0.0;
+};
+
+static Summary summarize(std::vector<double> values) {
+    Summary s;
+    s.count = values.size();
+    if (values.empty()) return s;
+    std::sort(values.begin(), values.end());
+    auto at = [&](double q) { return values[static_cast<size_t>(q * static_cast<double>(values.size() - 1))]; };
+    s.p50 = at(0.50);
+    s.p99 = at(0.99);
+    s.max = values.back();
+    return s;
+}
+
+static void print_summary(const char* name, const Summary& s) {
+    std::cout << std::left << std::setw(24) << name << std::right << std::fixed << std::setprecision(3)
+              << std::setw(10) << s.p50 << std::setw(10) << s.p99 << std::setw(10) << s.max
+              << std::setw(9) << s.count << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+}
+
+static void print_summary_header() {
+    std::cout << std::left << std::setw(24) << "" << std::right << std::setw(10) << "p50" << std::setw(10) << "p99"
+              << std::setw(10) << "max" << std::setw(9) << "n" << std::endl;
+}
+
+// ---------------------------------------------------------------------------
+// dump  stats
+// ---------------------------------------------------------------------------
+
+static void dump(const std::vector<TraceRecord>& records) {
+    std::cout << std::fixed;
+    for (const auto& r : records) {
+        std::cout << std::setprecision(3) << std::setw(12) << to_ms(r.time_ns) << "    " << r.thread
+                  << std::setw(8) << r.seq << "  " << std::left << std::setw(13) << trace_event_name(r.type) << std::right
+                  << std::setprecision(4) << std::setw(12) << r.a << std::setw(12) << r.b << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+}
+
+//     ; 0 -   
+struct PointPath {
+    uint64_t input = 0, handoff = 0, train_begin = 0, train_end = 0, visible = 0;
+    double x = 0.0, y = 0.0;
+};
+
+static void stats(const std::vector<TraceRecord>& records, const TraceFormat::FileHeader& header, size_t top) {
+    std::vector<PointPath> paths;
+    std::deque<size_t> waiting;            //  ,    
+    std::vector<size_t> training, shown;   // ,    / 
+    std::vector<uint64_t> train_started(65536, 0), render_started(65536, 0);
+    std::vector<double> render_ms, frame_interval_ms;
+    uint64_t last_frame = 0, dropped = 0;
+    size_t threads = 0;
+
+    for (const auto& r : records) {
+        threads = std::max<size_t>(threads, r.thread + 1u);
+        switch (static_cast<TraceEvent>(r.type)) {
+        case TraceEvent::Input: {
+            PointPath p;
+            p.input = r.time_ns;
+            p.x = r.a;
+            p.y = r.b;
+            waiting.push_back(paths.size());
+            paths.push_back(p);
+            break;
+        }
+        case TraceEvent::Handoff: {
+            //     ;     
+            //          
+            auto it = std::find_if(waiting.begin(), waiting.end(), [&](size_t i) { return paths[i].x == r.a && paths[i].y == r.b; });
+            if (it == waiting.end()) break;
+            paths[*it].handoff = r.time_ns;
+            training.push_back(*it);
+            waiting.erase(waiting.begin(), it + 1);
+            break;
+        }
+        case TraceEvent::TrainBegin:
+            train_started[r.thread] = r.time_ns;
+            break;
+        case TraceEvent::TrainEnd:
+            for (size_t i : training) {
+                paths[i].train_begin = train_started[r.thread];
+                paths[i].train_end = r.time_ns;
+                shown.push_back(i);
+            }
+            training.clear();
+            break;
+        case TraceEvent::RenderBegin:
+            render_started[r.thread] = r.time_ns;
+            if (last_frame > 0) frame_interval_ms.push_back(to_ms(r.time_ns - last_frame));
+            last_frame = r.time_ns;
+            break;
+        case TraceEvent::RenderEnd:
+            if (render_started[r.thread] > 0) render_ms.push_back(to_ms(r.time_ns - render_started[r.thread]));
+            // ,    ,    
+            shown.erase(std::remove_if(shown.begin(), shown.end(), [&](size_t i) {
+                if (paths[i].train_end > render_started[r.thread]) return false;
+                paths[i].visible = r.time_ns;
+                return true;
+            }), shown.end());
+            break;
+        case TraceEvent::Dropped:
+            dropped += static_cast<uint64_t>(r.a);
+            break;
+        default:
+            break;
+        }
+    }
+
+    std::vector<double> wait_ms, train_ms, total_ms;
+    size_t trained = 0;
+    for (const auto& p : paths) {
+        if (p.handoff) wait_ms.push_back(to_ms(p.handoff - p.input));
+        if (p.train_end) {
+            ++trained;
+            train_ms.push_back(to_ms(p.train_end - p.train_begin));
+        }
+        if (p.visible) total_ms.push_back(to_ms(p.visible - p.input));
+    }
+
+    double duration = records.empty() ? 0.0 : to_ms(records.back().time_ns) / 1000.0;
+    std::cout << " " << header.program << ":  " << records.size() << ",  " << threads
+              << ",  " << std::fixed << std::setprecision(2) << duration << " ,   " << dropped << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    std::cout << ":  " << paths.size() << ",  " << trained
+              << ",     " << paths.size() - trained << std::endl;
+    print_summary_header();
+    print_summary(" ", summarize(wait_ms));
+    print_summary("", summarize(train_ms));
+    print_summary(" -> ", summarize(total_ms));
+    print_summary(" ", summarize(render_ms));
+    print_summary(" ", summarize(frame_interval_ms));
+
+    std::vector<size_t> slow;
+    for (size_t i = 0; i < paths.size(); ++i) {
+        if (paths[i].visible) slow.push_back(i);
+    }
+    std::sort(slow.begin(), slow.end(), [&](size_t a, size_t b) {
+        return paths[a].visible - paths[a].input > paths[b].visible - paths[b].input;
+    });
+    if (slow.size() > top) slow.resize(top);
+    if (!slow.empty()) std::cout << "   ( -> ):" << std::endl;
+    std::cout << std::fixed;
+    for (size_t i : slow) {
+        const PointPath& p = paths[i];
+        std::cout << std::setprecision(3) << "  t = " << std::setw(10) << to_ms(p.input) / 1000.0 << "   ("
+                  << std::setprecision(2) << p.x << ", " << p.y << ")" << std::setprecision(3)
+                  << "   " << to_ms(p.handoff - p.input) << ",  " << to_ms(p.train_end - p.train_begin)
+                  << ",  " << to_ms(p.visible - p.input) << " " << std::endl;
+    }
+    std::cout.unsetf(std::ios::fixed);
+}
+
+// ---------------------------------------------------------------------------
+// replay
+// ---------------------------------------------------------------------------
+
+// ,    ;  x, y -  Prak1Fit::train
+struct ModelPoint {
+    double x, y;
+};
+
+//       ,     (LineFitPipelines.h)
+
+// main2.cpp:   O(1)     ,   MAX_POINTS 
+struct Main2Model {
+    static constexpr bool TRAINS_IN_FRAME_LOOP = true;
+
+    std::vector<ModelPoint> points;
+    FitTracker fit;
+    RobustRegressor robust;
+    Main2Fit::FitMode mode = Main2Fit::FitMode::Ols;
+
+    bool full() const { return points.size() >= Main2Fit::MAX_POINTS; }
+
+    void add(double x, double y) {
+        points.push_back({x, y});
+        fit.add(x, y);
+        robust.add(x, y);
+    }
+
+    void command(TraceCommand c) { mode = Main2Fit::from_trace_command(c); }
+
+    std::pair<double, double> solve() { return Main2Fit::solve(mode, fit, robust); }
+};
+
+// prak1_1.cpp:          
+struct Prak1Model {
+    static constexpr bool TRAINS_IN_FRAME_LOOP = false;
+
+    std::vector<ModelPoint> points;
+
+    bool full() const { return false; }
+
+    void add(double x, double y) { points.push_back({x, y}); }
+
+    void command(TraceCommand) {}
+
+    std::pair<double, double> solve() {
+        long long slope_fixed, intercept_fixed;
+        Prak1Fit::train(points, slope_fixed, intercept_fixed);
+        return {Prak1Fit::from_fixed(slope_fixed), Prak1Fit::from_fixed(intercept_fixed)};
+    }
+};
+
+template<typename Model>
+static int replay(const std::vector<TraceRecord>& records, const ReplayConfig& config, const std::string& pipeline) {
+    using Clock = std::chrono::steady_clock;
+
+    if (!config.trace_out.empty()) EventTrace::global().open(config.trace_out, pipeline.c_str());
+
+    Model model;
+    std::vector<TraceRecord> feed;
+    std::optional<std::pair<double, double>> recorded;
+    for (const auto& r : records) {
+        auto type = static_cast<TraceEvent>(r.type);
+        if (type == TraceEvent::Restored) {
+            model.add(r.a, r.b);
+            trace_event(TraceEvent::Restored, r.a, r.b);
+        }
+        else if (type == TraceEvent::Input || type == TraceEvent::Command) feed.push_back(r);
+        else if (type == TraceEvent::TrainEnd) recorded = std::make_pair(r.a, r.b);
+    }
+    size_t restored = model.points.size();
+    std::pair<double, double> coeffs{0.0, 0.0};
+    if (!model.points.empty()) coeffs = model.solve();
+
+    struct Pending {
+        double x, y;
+        Clock::time_point fed;
+    };
+    std::mutex mutex;
+    std::condition_variable slot_cv;
+    std::optional<Pending> slot;     //  ,  g_new_point  main2
+    bool refit = false;
+    bool input_done = false;
+    std::vector<double> latency_ms, render_ms;
+    size_t fed = 0, trained = 0, overwritten = 0, rejected = 0;
+
+    auto train_now = [&](const Pending* p) {
+        trace_event(TraceEvent::TrainBegin, static_cast<double>(model.points.size()));
+        coeffs = model.solve();
+        trace_event(TraceEvent::TrainEnd, coeffs.first, coeffs.second);
+        if (p) latency_ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - p->fed).count());
+    };
+
+    auto started = Clock::now();
+    std::thread input([&] {
+        uint64_t first = feed.empty() ? 0 : feed.front().time_ns;
+        for (const auto& r : feed) {
+            if (config.speed > 0.0) {
+                std::this_thread::sleep_until(started + std::chrono::nanoseconds(
+                    static_cast<int64_t>(static_cast<double>(r.time_ns - first) / config.speed)));
+            }
+            if (static_cast<TraceEvent>(r.type) == TraceEvent::Command) {
+                trace_event(TraceEvent::Command, r.a);
+                std::lock_guard<std::mutex> lock(mutex);
+                model.command(static_cast<TraceCommand>(static_cast<uint16_t>(r.a)));
+                refit = Model::TRAINS_IN_FRAME_LOOP;
+                continue;
+            }
+            trace_event(TraceEvent::Input, r.a, r.b);
+            Pending p{r.a, r.b, Clock::now()};
+            ++fed;
+            std::unique_lock<std::mutex> lock(mutex);
+            if (Model::TRAINS_IN_FRAME_LOOP) {
+                //  max   :  ,     
+                if (config.speed == 0.0) slot_cv.wait(lock, [&] { return !slot; });
+                if (model.full()) ++rejected;
+                else {
+                    if (slot) ++overwritten;
+                    slot = p;
+                }
+            } else {
+                trace_event(TraceEvent::Handoff, p.x, p.y);
+                model.add(p.x, p.y);
+                train_now(&p);
+                ++trained;
+            }
+        }
+        std::lock_guard<std::mutex> lock(mutex);
+        input_done = true;
+    });
+
+    double frame_ms = config.frame_ms >= 0.0 ? config.frame_ms : (config.speed > 0.0 ? 16.0 / config.speed : 0.0);
+    size_t frames = 0;
+    std::vector<ModelPoint> points_copy;
+    bool done = false;
+    while (!done) {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            if (Model::TRAINS_IN_FRAME_LOOP) {
+                std::optional<Pending> taken;
+                if (slot) {
+                    taken = slot;
+                    slot.reset();
+                    slot_cv.notify_one();
+                    trace_event(TraceEvent::Handoff, taken->x, taken->y);
+                    model.add(taken->x, taken->y);
+                    ++trained;
+                    refit = true;
+                }
+                if (refit) {
+                    refit = false;
+                    train_now(taken ? &*taken : nullptr);
+                }
+            }
+            //       
+            done = input_done && !slot && !refit;
+            points_copy = model.points;
+        }
+
+        //   : ,       
+        auto frame_start = Clock::now();
+        trace_event(TraceEvent::RenderBegin, static_cast<double>(points_copy.size()));
+        double bounds[4] = {-10.0, 10.0, -10.0, 10.0};
+        if (!points_copy.empty()) {
+            bounds[0] = bounds[1] = points_copy[0].x;
+            bounds[2] = bounds[3] = points_copy[0].y;
+            for (const auto& p : points_copy) {
+                bounds[0] = std::min(bounds[0], p.x);
+                bounds[1] = std::max(bounds[1], p.x);
+                bounds[2] = std::min(bounds[2], p.y);
+                bounds[3] = std::max(bounds[3], p.y);
+            }
+        }
+        trace_event(TraceEvent::RenderEnd, bounds[1] - bounds[0], bounds[3] - bounds[2]);
+        render_ms.push_back(std::chrono::duration<double, std::milli>(Clock::now() - frame_start).count());
+        ++frames;
+
+        if (done) break;
+        if (frame_ms > 0.0) std::this_thread::sleep_for(std::chrono::duration<double, std::milli>(frame_ms));
+        else std::this_thread::yield();
+    }
+    input.join();
+    double seconds = std::chrono::duration<double>(Clock::now() - started).count();
+    EventTrace::global().close();
+
+    std::cout << " " << pipeline << " (";
+    if (config.speed > 0.0) std::cout << " x" << config.speed;
+    else std::cout << " ";
+    std::cout << "):   " << restored << ",  " << fed << ",  " << trained
+              << ",     " << overwritten << ",   " << rejected << std::endl;
+    std::cout << std::fixed << std::setprecision(3) << " " << seconds << " , " << std::setprecision(1)
+              << (seconds > 0.0 ? static_cast<double>(trained) / seconds : 0.0) << " /,  " << frames << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    print_summary_header();
+    print_summary(" ->  ", summarize(latency_ms));
+    print_summary("", summarize(render_ms));
+
+    std::cout << std::fixed << std::setprecision(6) << ": m = " << coeffs.first << ", b = " << coeffs.second;
+    int status = 0;
+    if (recorded) {
+        double dm = std::abs(coeffs.first - recorded->first), db = std::abs(coeffs.second - recorded->second);
+        //         , 
+        //  ,      
+        bool same = dm <= 1e-9 * (1.0 + std::abs(recorded->first)) && db <= 1e-9 * (1.0 + std::abs(recorded->second));
+        std::cout << ";  : m = " << recorded->first << ", b = " << recorded->second
+                  << (same ? " - " : " - ");
+        if (!same && overwritten == 0) status = 2;
+    }
+    std::cout << std::endl;
+    std::cout.unsetf(std::ios::fixed);
+    return status;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        ReplayConfig config = parse_args(argc, argv);
+        TraceFormat::FileHeader header{};
+        std::vector<TraceRecord> records = read_trace(config.trace_file, &header);
+
+        if (config.command == "dump") {
+            dump(records);
+            return 0;
+        }
+        if (config.command == "stats") {
+            stats(records, header, config.top);
+            return 0;
+        }
+
+        std::string pipeline = config.pipeline.empty() ? std::string(header.program, strnlen(header.program, sizeof(header.program))) : config.pipeline;
+        if (pipeline == "main2") return replay<Main2Model>(records, config, pipeline);
+        if (pipeline == "prak1_1") return replay<Prak1Model>(records, config, pipeline);
+        throw std::runtime_error("Unknown pipeline '" + pipeline + "', use --pipeline main2|prak1_1");
+    } catch (const std::exception& e) {
+        std::cerr << " : " << e.what() << std::endl;
+        return 1;
+    }
+}
@@ -0,0 +1,114 @@
+#include <iostream>
+#include <iomanip>
+#include <string>
+#include <vector>
+#include <random>
+#include <stdexcept>
+#include <cstdint>
+#include <cmath>
+
+#include "QuantizedMlp.h"
+#include "UartLink.h"
+
+//      (   board_emulator).
+//      ,    
+//    .  --weights   
+//  -   .
+
+struct ClientConfig {
+    std::string device;
+    std::string weights_file;
+    int baud = 115200;
+    size_t count = 1000;
+    QuantizedMlp::ScaleMode scale_mode = QuantizedMlp::ScaleMode::Divide; //    ( --weights)
+    PipelinedUartClient::Options options;
+};
+
+static ClientConfig parse_args(int argc, char* argv[]) {
+    ClientConfig config;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        auto next = [&]() -> std::string {
+            if (i + 1 >= argc) throw std::runtime_error("Missing value for " + arg);
+            return argv[++i];
+        };
+        if (arg == "--weights") config.weights_file = next();
+        else if (arg == "--baud") config.baud = std::stoi(next());
+        else if (arg == "--count") config.count = std::stoul(next());
+        else if (arg == "--window") config.options.window = std::stoul(next());
+        else if (arg == "--canary") config.options.canary_interval = std::stoul(next());
+        else if (arg == "--timeout-ms") config.options.timeout_ms = std::stoi(next());
+        else if (arg == "--pipelined-rtl") config.scale_mode = QuantizedMlp::ScaleMode::InvScaleShift;
+        else if (config.device.empty()) config.device = arg;
+        else throw std::runtime_error("Unknown argument: " + arg);
+    }
+    if (config.device.empty()) {
+        throw std::runtime_error("Usage: uart_client <device> [--count N] [--window W] [--baud B] [--canary N] [--timeout-ms T] "
+                                 "[--weights network_weights.txt] [--pipelined-rtl]");
+    }
+    if (config.count == 0) throw std::runtime_error("--count must be positive");
+    return config;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        ClientConfig config = parse_args(argc, argv);
+        const int64_t SCALE = 100000;
+
+        //   ,      (й1)
+        std::mt19937 gen(2024);
+        std::uniform_real_distribution<> m_b_dist(-5.0, 5.0), x_dist(-10.0, 10.0);
+
+        std::vector<UartQuery> queries(config.count);
+        std::vector<std::pair<double, double>> truth(config.count);
+        for (size_t i = 0; i < config.count; ++i) {
+            double m = m_b_dist(gen), b = m_b_dist(gen);
+            for (int p = 0; p < 3; ++p) {
+                double x = x_dist(gen);
+                queries[i].coords[p * 2 + 0] = static_cast<int32_t>(std::llround(x * SCALE));
+                queries[i].coords[p * 2 + 1] = static_cast<int32_t>(std::llround((m * x + b) * SCALE));
+            }
+            truth[i] = {m, b};
+        }
+
+        SerialPort port(config.device, config.baud);
+        PipelinedUartClient client(port, config.options);
+
+        std::cout << " " << config.count << " ,  " << config.options.window << "..." << std::endl;
+        std::vector<UartReply> replies = client.run(queries);
+        const auto& stats = client.get_stats();
+
+        double err_m = 0.0, err_b = 0.0;
+        for (size_t i = 0; i < replies.size(); ++i) {
+            err_m += std::abs(static_cast<double>(replies[i].m) / SCALE - truth[i].first);
+            err_b += std::abs(static_cast<double>(replies[i].b) / SCALE - truth[i].second);
+        }
+
+        std::cout << std::fixed << std::setprecision(1);
+        std::cout << "/: " << stats.queries_per_second()
+                  << " ( " << std::setprecision(3) << stats.seconds << " )" << std::endl;
+        std::cout << ": " << stats.timeouts << ",  : " << stats.desyncs
+                  << ", : " << stats.resyncs
+                  << ", : " << stats.retransmitted << std::endl;
+        std::cout << std::setprecision(4) << " : |dm| = " << err_m / replies.size()
+                  << ", |db| = " << err_b / replies.size() << std::endl;
+
+        if (!config.weights_file.empty()) {
+            QuantizedMlp reference;
+            reference.load(config.weights_file);
+            reference.set_scale_mode(config.scale_mode);
+            size_t mismatches = 0;
+            for (size_t i = 0; i < replies.size(); ++i) {
+                int32_t out[QuantizedMlp::OUTPUT_SIZE];
+                reference.infer(queries[i].coords, out);
+                if (out[0] != replies[i].m || out[1] != replies[i].b) ++mismatches;
+            }
+            std::cout << "   : " << mismatches << "  " << replies.size() << std::endl;
+            if (mismatches > 0) return 2;
+        }
+    } catch (const std::exception& e) {
+        std::cerr << " : " << e.what() << std::endl;
+        return 1;
+    }
+    return 0;
+}
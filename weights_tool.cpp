@@ -0,0 +1,218 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <random>
+#include <stdexcept>
+#include <cstdio>
+#include <cctype>
+
+#include "QuantizedMlp.h"
+#include "SparseMlp.h"
+#include "WeightBundle.h"
+
+//     *.nwb:
+//   pack <network_weights.txt> <out.nwb>  -    й1
+//   mem  <weights> <>             -  w*.mem / b*.mem  $readmemh (RTL)
+//   info <out.nwb>                       - , ,  ,  
+//   sparse <weights>                     -   ,    SparseMlp
+//   header <weights> <out.h> [] [--pipelined-rtl]
+//                                        -   constexpr- StaticMlp (  );
+//                                           --pipelined-rtl  ,    RTL
+
+static void save_mem(const std::string& filename, size_t rows, size_t cols, const int32_t* data) {
+    std::ofstream outfile(filename);
+    if (!outfile) throw std::runtime_error("Cannot create " + filename);
+    //    quantize_and_save_hex    Python (й2,  3)
+    outfile << "//  : (" << rows << ", " << cols << ")\n";
+    outfile << "//   row-major   $readmemh\n";
+    char line[16];
+    for (size_t i = 0; i < rows * cols; ++i) {
+        std::snprintf(line, sizeof(line), "%08x\n", static_cast<uint32_t>(data[i]));
+        outfile << line;
+    }
+    std::cout << " : " << filename << " (" << rows * cols << " )" << std::endl;
+}
+
+static int cmd_pack(const std::string& input, const std::string& output) {
+    QuantizedMlp network;
+    network.load_text(input);
+    WeightBundle::write(output, network.get_scale(), network.export_ranges(), network.export_layers());
+    std::cout << "  : " << output << std::endl;
+    return 0;
+}
+
+static int cmd_mem(const std::string& input, const std::string& dir) {
+    QuantizedMlp network;
+    network.load(input);
+    const auto& layers = network.get_layers();
+    for (size_t l = 0; l < layers.size(); ++l) {
+        std::string suffix = std::to_string(l + 1) + ".mem";
+        save_mem(dir + "/w" + suffix, layers[l].inputs, layers[l].outputs, layers[l].weights);
+        save_mem(dir + "/b" + suffix, 1, layers[l].outputs, layers[l].bias);
+    }
+    return 0;
+}
+
+// ,     C++:     '_'
+static std::string header_identifier(std::string name) {
+    for (char& c : name) {
+        if (!std::isalnum(static_cast<unsigned char>(c))) c = '_';
+    }
+    if (name.empty() || std::isdigit(static_cast<unsigned char>(name[0]))) name = "weights_" + name;
+    return name;
+}
+
+//      -      
+static std::string header_namespace(const std::string& output) {
+    size_t slash = output.find_last_of('/');
+    std::string name = output.substr(slash == std::string::npos ? 0 : slash + 1);
+    return header_identifier(name.substr(0, name.find('.')));
+}
+
+static int cmd_header(const std::string& input, const std::string& output, std::string name, QuantizedMlp::ScaleMode scale_mode) {
+    QuantizedMlp network;
+    network.load(input);
+    bool explicit_name = !name.empty();
+    name = explicit_name ? header_identifier(name) : header_namespace(output);
+    bool shift = scale_mode == QuantizedMlp::ScaleMode::InvScaleShift;
+    const auto& layers = network.get_layers();
+    QuantizedMlp::FixedPointConstants c = network.fixed_point_constants();
+
+    std::ofstream out(output);
+    if (!out) throw std::runtime_error("Cannot create " + output);
+    std::string shape = std::to_string(layers.front().inputs);
+    for (const auto& layer : layers) shape += ", " + std::to_string(layer.outputs);
+
+    out << "#pragma once\n#include \"StaticMlp.h\"\n\n";
+    out << "// : weights_tool header " << input << " " << output << (explicit_name ? " " + name : "")
+        << (shift ? " --pipelined-rtl" : "") << "\n";
+    out << "//    ;       .\n";
+    out << "namespace " << name << " {\n\n";
+    out << "using Network = StaticMlp<" << shape << ">;\n\n";
+    out << "constexpr Network NETWORK{\n";
+    out << "    // SCALE, INV_SCALE, X_MIN_FP, X_HALF_RANGE, Y_MIN_FP, Y_HALF_RANGE, MB_MIN_FP, MB_HALF_RANGE\n";
+    out << "    {" << c.scale << ", " << c.inv_scale << ", " << c.x_min_fp << ", " << c.x_half_range << ", "
+        << c.y_min_fp << ", " << c.y_half_range << ", " << c.mb_min_fp << ", " << c.mb_half_range << "},\n";
+    out << "    Network::ScaleMode::" << (shift ? "InvScaleShift" : "Divide") << ",\n";
+    out << "    {{\n";
+    auto write_values = [&](const char* title, size_t l, size_t rows, size_t cols, const int32_t* data) {
+        out << "        // " << title << l + 1 << " (" << rows << " x " << cols << ")\n";
+        for (size_t i = 0; i < rows * cols; ++i) {
+            if (i % 12 == 0) out << "        ";
+            out << data[i] << ",";
+            out << ((i % 12 == 11 || i + 1 == rows * cols) ? "\n" : " ");
+        }
+    };
+    for (size_t l = 0; l < layers.size(); ++l) {
+        write_values("W", l, layers[l].inputs, layers[l].outputs, layers[l].weights);
+        write_values("B", l, 1, layers[l].outputs, layers[l].bias);
+    }
+    out << "    }}\n};\n\n} // namespace " << name << "\n";
+    if (!out) throw std::runtime_error("Failed to write " + output);
+
+    std::cout << " : " << output << " (" << name << "::NETWORK, StaticMlp<" << shape << ">, "
+              << (shift ? " " : "") << ")" << std::endl;
+    return 0;
+}
+
+static int cmd_info(const std::string& input) {
+    auto start = std::chrono::steady_clock::now();
+    QuantizedMlp network;
+    network.load_bundle(input);
+    auto elapsed = std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+
+    WeightBundle bundle(input);
+    const auto& h = bundle.header();
+    const auto& r = bundle.ranges();
+    std::cout << ": " << h.version << ", : " << h.file_size << " , SCALE = " << h.scale << std::endl;
+    std::cout << ": x [" << r.x_min << ", " << r.x_max << "], y [" << r.y_min << ", " << r.y_max
+              << "], m/b [" << r.mb_min << ", " << r.mb_max << "]" << std::endl;
+    for (uint32_t l = 0; l < bundle.layer_count(); ++l) {
+        std::cout << " " << l + 1 << ": " << bundle.layer(l).inputs << " -> " << bundle.layer(l).outputs << std::endl;
+    }
+    bool ok = bundle.verify_checksum();
+    std::cout << " : " << (ok ? "" : " ") << std::endl;
+    std::cout << "   : " << std::fixed << std::setprecision(1) << elapsed << " " << std::endl;
+    return ok ? 0 : 2;
+}
+
+static int cmd_sparse(const std::string& input) {
+    QuantizedMlp network;
+    network.load(input);
+    SparseMlp sparse(network);
+
+    const auto& layers = sparse.get_layers();
+    for (size_t l = 0; l < layers.size(); ++l) {
+        const auto& layer = layers[l];
+        size_t blocks = (layer.outputs + SparseMlp::BLOCK - 1) / SparseMlp::BLOCK * layer.inputs;
+        size_t empty_rows = 0;
+        for (uint32_t i = 0; i < layer.inputs; ++i) {
+            if (layer.row_start[i] == layer.row_start[i + 1]) ++empty_rows;
+        }
+        std::cout << " " << l + 1 << ": " << layer.inputs << " -> " << layer.outputs << ",  "
+                  << layer.block_col.size() << "  " << blocks << ",   ( ): "
+                  << empty_rows << std::endl;
+    }
+    std::cout << "  : " << sparse.macs() << "  " << sparse.dense_macs() << " ("
+              << std::fixed << std::setprecision(1) << 100.0 * sparse.macs() / sparse.dense_macs() << "%)" << std::endl;
+
+    //       
+    const size_t SAMPLES = 200000;
+    BundleRanges r = network.export_ranges();
+    std::mt19937 gen(11);
+    std::uniform_real_distribution<> x_dist(r.x_min, r.x_max), y_dist(r.y_min, r.y_max);
+    std::vector<int32_t> coords(SAMPLES * QuantizedMlp::INPUT_SIZE);
+    for (size_t i = 0; i < coords.size(); i += 2) {
+        coords[i] = network.to_fixed(x_dist(gen));
+        coords[i + 1] = network.to_fixed(y_dist(gen));
+    }
+
+    std::vector<int32_t> dense_out(SAMPLES * 2), sparse_out(SAMPLES * 2);
+    std::vector<int32_t> a(sparse.buffer_size()), z(sparse.buffer_size());
+    std::vector<int64_t> acc(sparse.buffer_size());
+    auto start = std::chrono::steady_clock::now();
+    for (size_t s = 0; s < SAMPLES; ++s) network.infer(&coords[s * 6], &dense_out[s * 2], a.data(), z.data());
+    double dense_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    start = std::chrono::steady_clock::now();
+    for (size_t s = 0; s < SAMPLES; ++s) sparse.infer(&coords[s * 6], &sparse_out[s * 2], a.data(), z.data(), acc.data());
+    double sparse_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < dense_out.size(); ++i) {
+        if (dense_out[i] != sparse_out[i]) ++mismatches;
+    }
+    std::cout << " : " << std::setprecision(0) << SAMPLES / dense_seconds << " /, : "
+              << SAMPLES / sparse_seconds << " / (x" << std::setprecision(2) << dense_seconds / sparse_seconds
+              << ")" << std::endl;
+    std::cout << "  QuantizedMlp: " << mismatches << "  " << dense_out.size() << std::endl;
+    return mismatches == 0 ? 0 : 2;
+}
+
+int main(int argc, char* argv[]) {
+    try {
+        std::string cmd = argc > 1 ? argv[1] : "";
+        if (cmd == "pack" && argc == 4) return cmd_pack(argv[2], argv[3]);
+        if (cmd == "mem" && argc == 4) return cmd_mem(argv[2], argv[3]);
+        if (cmd == "info" && argc == 3) return cmd_info(argv[2]);
+        if (cmd == "sparse" && argc == 3) return cmd_sparse(argv[2]);
+        if (cmd == "header") {
+            std::vector<std::string> args;
+            QuantizedMlp::ScaleMode scale_mode = QuantizedMlp::ScaleMode::Divide;
+            for (int i = 2; i < argc; ++i) {
+                std::string arg = argv[i];
+                if (arg == "--pipelined-rtl") scale_mode = QuantizedMlp::ScaleMode::InvScaleShift;
+                else args.push_back(arg);
+            }
+            if (args.size() == 2 || args.size() == 3) return cmd_header(args[0], args[1], args.size() == 3 ? args[2] : "", scale_mode);
+        }
+        std::cerr << ": weights_tool pack <txt> <nwb> | mem <weights> <dir> | info <nwb> | sparse <weights>"
+                     " | header <weights> <out.h> [] [--pipelined-rtl]" << std::endl;
+        return 1;
+    } catch (const std::exception& e) {
+        std::cerr << " : " << e.what() << std::endl;
+        return 1;
+    }
+}
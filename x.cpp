@@ -0,0 +1,2 @@
+#include "x.h"
+int main(){return weights_9bad_name_::NETWORK.params[0]==0;}
@@ -0,0 +1,92 @@
+#pragma once
+#include "StaticMlp.h"
+
+// Сгенерировано: weights_tool header /tmp/network_weights.nwb x.h weights_9bad_name_
+// Веса вписаны в код; после переобучения сети заголовок нужно сгенерировать заново.
+namespace weights_9bad_name_ {
+
+using Network = StaticMlp<6, 32, 16, 2>;
+
+constexpr Network NETWORK{
+    // SCALE, INV_SCALE, X_MIN_FP, X_HALF_RANGE, Y_MIN_FP, Y_HALF_RANGE, MB_MIN_FP, MB_HALF_RANGE
+    {100000, 42950, -1000000, 10, 4500000, 5, -500000, 5},
+    Network::ScaleMode::Divide,
+    {{
+        // W1 (6 x 32)
+        12791, 25527, -17041, 44685, -12114, -30785, -5824, 7787, 19996, 14233, -22467, -2189,
+        11070, -8843, 8342, 18993, -23904, -27208, 34374, 9964, 22256, 5187, -23562, 18237,
+        17980, 34253, 31908, -16630, -15923, -6974, -1213, 18360, 4486, -16234, -6433, -16054,
+        12997, -3800, -15837, 5692, 7364, -12166, -6081, -5675, -14077, -5717, -14555, 18508,
+        -21246, 2924, -7413, 22842, 16550, -10396, 9311, -7595, 4486, 8578, -5343, -7344,
+        -1489, 2659, -8877, 7750, 37284, -29664, -15427, 27, -21579, 48560, 321, -2388,
+        18004, -9919, 13989, 9242, -4865, 14855, 9599, -17146, 498, -4947, -4091, 11377,
+        -28161, 19289, 35746, -34679, 6345, -30235, 19481, -24983, -26199, 40855, -7597, 16676,
+        -2400, -6901, 13078, -18300, 3599, -21286, 4044, -1347, 12128, 6897, -11034, 22451,
+        874, -18192, 516, 11139, -17536, 520, -5990, 6001, -7631, -21185, -4752, -17162,
+        -6762, -18341, -2667, -15242, -3029, -6921, 14617, -10018, -41776, -29167, 4497, -8452,
+        -6069, 19159, 4467, 9974, 5194, -13281, 15614, -3831, 12971, -10313, -28076, 20059,
+        35045, 35675, -2661, -20370, 22899, -21719, -24125, -14979, -21295, -19837, -10529, -20410,
+        55867, -15594, -32583, 3926, -4019, -8079, 23227, 10900, 11899, -146, -22563, 14402,
+        12033, 3102, -4228, -13684, -15017, 2700, -11218, 19108, -9754, -3791, 11216, -4439,
+        -21404, -17713, -11021, 1862, -18934, -15685, 3996, 1686, 5685, 2291, -10336, -2175,
+        // B1 (1 x 32)
+        -6742, 22664, 21479, 1361, -8830, -5896, 2817, -18713, -717, 23068, 14640, 10115,
+        -2330, 3311, 19546, -11891, -8043, -4048, -15233, 22465, -11785, -16022, -6710, -26192,
+        3464, 3577, -25912, 22560, 11187, -18336, -9241, -9399,
+        // W2 (32 x 16)
+        -17644, 12665, -31719, -10123, 11779, -19706, -28169, -25083, -22779, 7850, -14478, -199,
+        -11567, 6531, -385, 12798, 10378, 17941, 15210, -8848, 5876, 9644, -12239, -2107,
+        16140, 13341, -9897, 17555, 7204, -30744, -18235, -5717, 12350, -4097, -3746, -3435,
+        11450, 8729, -19752, -7501, 1398, 10138, 4475, -11594, 6047, 7248, 14674, 12160,
+        -7319, -17596, 14964, -25099, 25239, 3814, -834, -2821, -7116, -1123, 12589, -6243,
+        12877, -14853, -1817, 18671, 885, -14591, -8066, 12535, -7375, -19546, -717, -19347,
+        232, 17066, -11963, 17388, -9091, -13225, 20017, 7865, 8244, -16184, -42422, 17135,
+        -22609, -17836, 1510, -4126, 5059, 2963, 15559, 12776, -6716, 26400, 14181, 5378,
+        -9507, 13865, 1433, 15692, -16657, -7859, 15392, 8410, -9729, -1255, 103, -10071,
+        -9792, -1104, 12230, -976, 2949, -6433, 4477, -15489, -18824, 20413, -9474, -9919,
+        -9106, -10135, 16238, 13684, -14439, 20227, -5890, 1932, -342, -15119, 14677, -11503,
+        13258, 20342, 20053, -13989, -1210, 8469, -6532, 8014, 10141, 12960, 14194, -17082,
+        -8475, 2396, 24311, -24291, -323, 4744, 3667, -10097, 17580, 154, 8318, 4993,
+        4161, 18083, -16149, 15393, -9190, -16218, -21218, 14656, -22932, 4766, -17678, 14039,
+        -377, 12329, 8963, 3054, -11547, 9708, 4386, 10613, 11678, -5484, -9687, -18292,
+        -1380, 14649, 14236, 6203, 3431, -14983, -19510, -4070, -6696, 18476, -3895, -1261,
+        -37, -6919, -5887, 14274, 13533, -2706, 14265, -9562, -11082, -11676, -3255, -19133,
+        18659, -2780, 1034, 20880, -9221, -3135, -11483, 13431, -372, -1948, -18199, -19458,
+        -10827, -19654, -9200, 26085, -9843, -6714, -11128, 13246, -4199, 7770, 4096, -18532,
+        11997, -6562, 4900, 10783, 9880, 10765, 5636, 20141, -22015, 8839, -17272, 9568,
+        -19391, -17723, -7094, 3426, -16305, 79, 12288, -17540, 13835, 7768, -15344, 1371,
+        14062, 4791, 20189, -6769, 11791, -5118, 1520, 22522, -29733, 9824, 15843, 1748,
+        -11772, -12177, 2710, -31567, -19856, 18040, 8829, -23113, -12658, 5623, 23094, 19376,
+        -4146, -18400, 1856, 29799, 19242, -12023, -10950, 21585, 9583, -3068, 19249, 19759,
+        -18901, 1374, 25553, 1202, 16205, 2328, 13538, 12262, 6346, -18392, -9286, 10584,
+        2938, 11647, 1305, 2946, 8570, -7602, -5335, 1945, -10225, 8284, -2958, -5865,
+        16924, -18208, 9081, 4029, -3663, -13588, -5549, -10028, 4258, 16498, 21038, 8711,
+        11573, 17385, 12019, 2010, -1422, -10800, -20010, -36154, -54, -13621, 5951, 7007,
+        -18784, -7622, -7189, -7550, 5339, -5938, -2592, 11487, -14238, 4181, -18957, 3550,
+        15397, 16788, 11196, -12490, -16897, -8455, -37606, -14851, 13139, 3837, -5276, 21112,
+        9118, -17209, -11403, 27524, 15551, 19272, -11118, 1649, -17681, -15124, 9858, -20695,
+        29789, 9889, -4443, 518, -10882, 10197, 13347, -11755, -1037, -23923, -20615, -22262,
+        -1726, -7011, 11332, 11403, 14669, -22029, -15774, -13793, 8404, -5406, 2606, 21778,
+        10284, -3545, -18702, 2875, 6877, -18813, 7589, -22095, 16727, 18344, 1538, 9077,
+        6096, -7597, -17404, -3032, -15194, -29170, -12564, 7697, 1611, 7059, 17063, 12534,
+        -13867, -5665, -14654, 28504, -23530, 16032, -14089, -3003, 17884, -12849, -8686, -7242,
+        -7120, 18403, 9995, -10518, -15102, 10271, -3881, -1130, 26230, 9143, -13447, 10065,
+        2056, -4699, 11447, -11987, 14422, -683, -36258, -15113, 11229, -4823, 6587, -38156,
+        213, 7478, 5981, -35620, -7773, -3861, 14255, 3142, -19183, 17891, -11017, 22865,
+        -21183, -6464, 75, 23335, 8931, -9452, 18815, 21443, -10284, 17527, 731, -937,
+        10086, 16042, 6303, -21254, 11275, 33, -9721, -8183, -2996, 14984, 18038, -9287,
+        14008, 7014, -9647, -15466, 5401, -3865, 9804, -1322, 15400, -6017, 19334, 14980,
+        -9819, -14244, 13838, 12905, -16221, -7848, 6889, 1926,
+        // B2 (1 x 16)
+        26623, -21272, 20607, -2481, 3448, -26424, -12052, 3517, 73055, 9147, -33946, 18054,
+        -9916, 20566, -7266, 43177,
+        // W3 (16 x 2)
+        -29266, 22298, -9934, 31369, -85026, -4849, -54794, 6868, 67925, 3552, 33349, 3882,
+        -27722, 3151, -54089, -36319, -56411, 59693, 1112, -5478, 15458, -32361, -76793, 13971,
+        22222, 26003, 63504, 1024, -26510, 32559, 1820, 45040,
+        // B3 (1 x 2)
+        67188, 6240,
+    }}
+};
+
+} // namespace weights_9bad_name_